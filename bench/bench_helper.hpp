@@ -0,0 +1,243 @@
+//: bench_helper.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include "vb6_alloc_stats.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct bench_result
+{
+  std::string name;
+  std::size_t iterations = 0;
+  double ns_per_iteration = 0.0;
+  double bytes_per_second = 0.0;
+
+  // of a single call, zero when the allocation hook is not installed
+  std::size_t allocations = 0;
+  std::size_t alloc_bytes = 0;
+  std::size_t peak_bytes = 0;
+  bool alloc_hook = false; // whether the counts above were taken
+
+  // false when the input stopped parsing early, the timing is then of the
+  // failure path and the comparison with the baseline fails
+  bool parsed = true;
+};
+
+// Runs fn() repeatedly for at least min_time and reports the average time of one call.
+// bytes is the amount of input processed by a single call, used for the throughput.
+inline bench_result run_bench(std::string name, std::size_t bytes, std::function<void()> const& fn,
+                              std::chrono::milliseconds min_time = std::chrono::milliseconds(300))
+{
+  using clock = std::chrono::steady_clock;
+
+  bench_result res;
+
+  // warm-up, also counting the allocations
+  {
+    vb6_grammar::alloc_scope scope;
+    fn();
+    auto const allocs = scope.delta();
+    res.allocations = allocs.allocations;
+    res.alloc_bytes = allocs.bytes;
+    res.peak_bytes = allocs.peak_bytes;
+    res.alloc_hook = vb6_grammar::alloc_hook_active();
+  }
+
+  std::size_t iterations = 0;
+  std::size_t batch = 1;
+  auto const start = clock::now();
+  auto elapsed = clock::duration::zero();
+
+  while(elapsed < min_time)
+  {
+    for(std::size_t i = 0; i < batch; ++i)
+      fn();
+    iterations += batch;
+    batch *= 2;
+    elapsed = clock::now() - start;
+  }
+
+  res.name = std::move(name);
+  res.iterations = iterations;
+  res.ns_per_iteration = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+  res.bytes_per_second = bytes * 1e9 / res.ns_per_iteration;
+  return res;
+}
+
+inline void print_bench_results(std::ostream& os, std::vector<bench_result> const& results)
+{
+  os << std::left << std::setw(40) << "benchmark"
+     << std::right << std::setw(12) << "iterations"
+     << std::setw(16) << "ns/iter"
+     << std::setw(14) << "MB/s" << '\n';
+
+  for(auto& r : results)
+  {
+    os << std::left << std::setw(40) << r.name
+       << std::right << std::setw(12) << r.iterations
+       << std::setw(16) << std::fixed << std::setprecision(1) << r.ns_per_iteration
+       << std::setw(14) << std::setprecision(2) << r.bytes_per_second / 1e6 << '\n';
+  }
+}
+
+inline void write_bench_json(std::ostream& os, std::vector<bench_result> const& results)
+{
+  os << "{\n  \"results\": [\n";
+  for(std::size_t i = 0; i < results.size(); ++i)
+  {
+    auto& r = results[i];
+    os << "    { \"name\": \"" << r.name << "\""
+       << ", \"iterations\": " << r.iterations
+       << std::fixed << std::setprecision(1)
+       << ", \"ns_per_iteration\": " << r.ns_per_iteration
+       << ", \"bytes_per_second\": " << r.bytes_per_second
+       << ", \"allocations\": " << r.allocations
+       << ", \"alloc_bytes\": " << r.alloc_bytes
+       << ", \"peak_bytes\": " << r.peak_bytes
+       << ", \"alloc_hook\": " << (r.alloc_hook ? "true" : "false")
+       << ", \"parsed\": " << (r.parsed ? "true" : "false")
+       << " }" << (i + 1 < results.size() ? "," : "") << '\n';
+  }
+  os << "  ]\n}\n";
+}
+
+namespace bench_detail {
+
+  // value following "key": in a flat JSON object
+  inline std::optional<std::string_view> json_value(std::string_view obj, std::string_view key)
+  {
+    auto const quoted = "\"" + std::string(key) + "\"";
+    auto pos = obj.find(quoted);
+    if(pos == std::string_view::npos)
+      return {};
+    pos = obj.find(':', pos + quoted.size());
+    if(pos == std::string_view::npos)
+      return {};
+    pos = obj.find_first_not_of(" \t\r\n", pos + 1);
+    if(pos == std::string_view::npos)
+      return {};
+    if(obj[pos] == '"')
+    {
+      auto const end = obj.find('"', pos + 1);
+      return obj.substr(pos + 1, end - pos - 1);
+    }
+    auto const end = obj.find_first_of(",} \t\r\n", pos);
+    return obj.substr(pos, end - pos);
+  }
+
+  inline double json_number(std::string_view obj, std::string_view key)
+  {
+    auto const value = json_value(obj, key);
+    return value ? std::stod(std::string(*value)) : 0.0;
+  }
+}
+
+// reads back what write_bench_json wrote
+inline std::vector<bench_result> read_bench_json(std::istream& is)
+{
+  std::string const text{ std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>() };
+  std::vector<bench_result> results;
+
+  auto pos = text.find('[');
+  while(pos != std::string::npos)
+  {
+    auto const begin = text.find('{', pos);
+    if(begin == std::string::npos)
+      break;
+    auto const end = text.find('}', begin);
+    if(end == std::string::npos)
+      break;
+    std::string_view const obj(text.data() + begin, end - begin + 1);
+
+    bench_result r;
+    r.name = std::string(bench_detail::json_value(obj, "name").value_or(""));
+    r.iterations = static_cast<std::size_t>(bench_detail::json_number(obj, "iterations"));
+    r.ns_per_iteration = bench_detail::json_number(obj, "ns_per_iteration");
+    r.bytes_per_second = bench_detail::json_number(obj, "bytes_per_second");
+    r.allocations = static_cast<std::size_t>(bench_detail::json_number(obj, "allocations"));
+    r.alloc_bytes = static_cast<std::size_t>(bench_detail::json_number(obj, "alloc_bytes"));
+    r.peak_bytes = static_cast<std::size_t>(bench_detail::json_number(obj, "peak_bytes"));
+    // older files tell whether allocations got counted only by the counts
+    r.alloc_hook = bench_detail::json_value(obj, "alloc_hook").value_or(r.peak_bytes != 0 ? "true" : "false") == "true";
+    r.parsed = bench_detail::json_value(obj, "parsed").value_or("true") == "true";
+    results.push_back(std::move(r));
+
+    pos = end + 1;
+  }
+  return results;
+}
+
+// Compares time per call, allocations and peak memory with the baseline.
+// Returns the number of metrics that got worse by more than threshold_pct,
+// or at all from zero, counting as well the benchmarks whose input did not
+// parse, those missing from the baseline and those without the allocation
+// counts the baseline has, which cannot be gated.
+inline std::size_t compare_bench_results(std::ostream& os, std::vector<bench_result> const& baseline,
+                                         std::vector<bench_result> const& current, double threshold_pct)
+{
+  std::size_t regressions = 0;
+
+  auto check = [&](std::string const& name, char const* metric, double before, double now) {
+    // there is no percentage of zero, anything more is a regression
+    auto const change = before > 0.0 ? (now - before) * 100.0 / before : 0.0;
+    bool const regressed = before > 0.0 ? change > threshold_pct : now > 0.0;
+    regressions += regressed;
+    os << std::left << std::setw(40) << name << std::setw(18) << metric
+       << std::right << std::fixed << std::setprecision(1)
+       << std::setw(16) << before << std::setw(16) << now;
+    if(before > 0.0)
+      os << std::setw(9) << std::showpos << change << '%' << std::noshowpos;
+    else
+      os << std::setw(10) << (regressed ? "from 0" : "");
+    os << (regressed ? "  REGRESSION" : "") << '\n';
+  };
+
+  for(auto& cur : current)
+  {
+    bench_result const* base = nullptr;
+    for(auto& b : baseline)
+    {
+      if(b.name == cur.name)
+        base = &b;
+    }
+    if(!cur.parsed)
+    {
+      os << std::left << std::setw(40) << cur.name << "input did not parse  FAILED\n";
+      ++regressions;
+      continue;
+    }
+    if(!base)
+    {
+      os << std::left << std::setw(40) << cur.name << "not in the baseline  FAILED\n";
+      ++regressions;
+      continue;
+    }
+    check(cur.name, "ns/iter", base->ns_per_iteration, cur.ns_per_iteration);
+    if(!base->alloc_hook)
+      continue;
+    if(!cur.alloc_hook)
+    {
+      os << std::left << std::setw(40) << cur.name << "allocations not counted  FAILED\n";
+      ++regressions;
+      continue;
+    }
+    check(cur.name, "allocations", static_cast<double>(base->allocations), static_cast<double>(cur.allocations));
+    check(cur.name, "peak bytes", static_cast<double>(base->peak_bytes), static_cast<double>(cur.peak_bytes));
+  }
+
+  return regressions;
+}
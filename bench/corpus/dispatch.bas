@@ -0,0 +1,693 @@
+Attribute VB_Name = "dispatch"
+Option Explicit
+
+Sub dispatch0()
+    Select Case command
+    Case 0
+        Call run("command0", 0)
+    Case 1
+        Call run("command1", 0)
+    Case 2
+        Call run("command2", 0)
+    Case 3
+        Call run("command3", 0)
+    Case 4
+        Call run("command4", 0)
+    Case 5
+        Call run("command5", 0)
+    Case 6
+        Call run("command6", 0)
+    Case 7
+        Call run("command7", 0)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch1()
+    Select Case command
+    Case 0
+        Call run("command0", 1)
+    Case 1
+        Call run("command1", 1)
+    Case 2
+        Call run("command2", 1)
+    Case 3
+        Call run("command3", 1)
+    Case 4
+        Call run("command4", 1)
+    Case 5
+        Call run("command5", 1)
+    Case 6
+        Call run("command6", 1)
+    Case 7
+        Call run("command7", 1)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch2()
+    Select Case command
+    Case 0
+        Call run("command0", 2)
+    Case 1
+        Call run("command1", 2)
+    Case 2
+        Call run("command2", 2)
+    Case 3
+        Call run("command3", 2)
+    Case 4
+        Call run("command4", 2)
+    Case 5
+        Call run("command5", 2)
+    Case 6
+        Call run("command6", 2)
+    Case 7
+        Call run("command7", 2)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch3()
+    Select Case command
+    Case 0
+        Call run("command0", 3)
+    Case 1
+        Call run("command1", 3)
+    Case 2
+        Call run("command2", 3)
+    Case 3
+        Call run("command3", 3)
+    Case 4
+        Call run("command4", 3)
+    Case 5
+        Call run("command5", 3)
+    Case 6
+        Call run("command6", 3)
+    Case 7
+        Call run("command7", 3)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch4()
+    Select Case command
+    Case 0
+        Call run("command0", 4)
+    Case 1
+        Call run("command1", 4)
+    Case 2
+        Call run("command2", 4)
+    Case 3
+        Call run("command3", 4)
+    Case 4
+        Call run("command4", 4)
+    Case 5
+        Call run("command5", 4)
+    Case 6
+        Call run("command6", 4)
+    Case 7
+        Call run("command7", 4)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch5()
+    Select Case command
+    Case 0
+        Call run("command0", 5)
+    Case 1
+        Call run("command1", 5)
+    Case 2
+        Call run("command2", 5)
+    Case 3
+        Call run("command3", 5)
+    Case 4
+        Call run("command4", 5)
+    Case 5
+        Call run("command5", 5)
+    Case 6
+        Call run("command6", 5)
+    Case 7
+        Call run("command7", 5)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch6()
+    Select Case command
+    Case 0
+        Call run("command0", 6)
+    Case 1
+        Call run("command1", 6)
+    Case 2
+        Call run("command2", 6)
+    Case 3
+        Call run("command3", 6)
+    Case 4
+        Call run("command4", 6)
+    Case 5
+        Call run("command5", 6)
+    Case 6
+        Call run("command6", 6)
+    Case 7
+        Call run("command7", 6)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch7()
+    Select Case command
+    Case 0
+        Call run("command0", 7)
+    Case 1
+        Call run("command1", 7)
+    Case 2
+        Call run("command2", 7)
+    Case 3
+        Call run("command3", 7)
+    Case 4
+        Call run("command4", 7)
+    Case 5
+        Call run("command5", 7)
+    Case 6
+        Call run("command6", 7)
+    Case 7
+        Call run("command7", 7)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch8()
+    Select Case command
+    Case 0
+        Call run("command0", 8)
+    Case 1
+        Call run("command1", 8)
+    Case 2
+        Call run("command2", 8)
+    Case 3
+        Call run("command3", 8)
+    Case 4
+        Call run("command4", 8)
+    Case 5
+        Call run("command5", 8)
+    Case 6
+        Call run("command6", 8)
+    Case 7
+        Call run("command7", 8)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch9()
+    Select Case command
+    Case 0
+        Call run("command0", 9)
+    Case 1
+        Call run("command1", 9)
+    Case 2
+        Call run("command2", 9)
+    Case 3
+        Call run("command3", 9)
+    Case 4
+        Call run("command4", 9)
+    Case 5
+        Call run("command5", 9)
+    Case 6
+        Call run("command6", 9)
+    Case 7
+        Call run("command7", 9)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch10()
+    Select Case command
+    Case 0
+        Call run("command0", 10)
+    Case 1
+        Call run("command1", 10)
+    Case 2
+        Call run("command2", 10)
+    Case 3
+        Call run("command3", 10)
+    Case 4
+        Call run("command4", 10)
+    Case 5
+        Call run("command5", 10)
+    Case 6
+        Call run("command6", 10)
+    Case 7
+        Call run("command7", 10)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch11()
+    Select Case command
+    Case 0
+        Call run("command0", 11)
+    Case 1
+        Call run("command1", 11)
+    Case 2
+        Call run("command2", 11)
+    Case 3
+        Call run("command3", 11)
+    Case 4
+        Call run("command4", 11)
+    Case 5
+        Call run("command5", 11)
+    Case 6
+        Call run("command6", 11)
+    Case 7
+        Call run("command7", 11)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch12()
+    Select Case command
+    Case 0
+        Call run("command0", 12)
+    Case 1
+        Call run("command1", 12)
+    Case 2
+        Call run("command2", 12)
+    Case 3
+        Call run("command3", 12)
+    Case 4
+        Call run("command4", 12)
+    Case 5
+        Call run("command5", 12)
+    Case 6
+        Call run("command6", 12)
+    Case 7
+        Call run("command7", 12)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch13()
+    Select Case command
+    Case 0
+        Call run("command0", 13)
+    Case 1
+        Call run("command1", 13)
+    Case 2
+        Call run("command2", 13)
+    Case 3
+        Call run("command3", 13)
+    Case 4
+        Call run("command4", 13)
+    Case 5
+        Call run("command5", 13)
+    Case 6
+        Call run("command6", 13)
+    Case 7
+        Call run("command7", 13)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch14()
+    Select Case command
+    Case 0
+        Call run("command0", 14)
+    Case 1
+        Call run("command1", 14)
+    Case 2
+        Call run("command2", 14)
+    Case 3
+        Call run("command3", 14)
+    Case 4
+        Call run("command4", 14)
+    Case 5
+        Call run("command5", 14)
+    Case 6
+        Call run("command6", 14)
+    Case 7
+        Call run("command7", 14)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch15()
+    Select Case command
+    Case 0
+        Call run("command0", 15)
+    Case 1
+        Call run("command1", 15)
+    Case 2
+        Call run("command2", 15)
+    Case 3
+        Call run("command3", 15)
+    Case 4
+        Call run("command4", 15)
+    Case 5
+        Call run("command5", 15)
+    Case 6
+        Call run("command6", 15)
+    Case 7
+        Call run("command7", 15)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch16()
+    Select Case command
+    Case 0
+        Call run("command0", 16)
+    Case 1
+        Call run("command1", 16)
+    Case 2
+        Call run("command2", 16)
+    Case 3
+        Call run("command3", 16)
+    Case 4
+        Call run("command4", 16)
+    Case 5
+        Call run("command5", 16)
+    Case 6
+        Call run("command6", 16)
+    Case 7
+        Call run("command7", 16)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch17()
+    Select Case command
+    Case 0
+        Call run("command0", 17)
+    Case 1
+        Call run("command1", 17)
+    Case 2
+        Call run("command2", 17)
+    Case 3
+        Call run("command3", 17)
+    Case 4
+        Call run("command4", 17)
+    Case 5
+        Call run("command5", 17)
+    Case 6
+        Call run("command6", 17)
+    Case 7
+        Call run("command7", 17)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch18()
+    Select Case command
+    Case 0
+        Call run("command0", 18)
+    Case 1
+        Call run("command1", 18)
+    Case 2
+        Call run("command2", 18)
+    Case 3
+        Call run("command3", 18)
+    Case 4
+        Call run("command4", 18)
+    Case 5
+        Call run("command5", 18)
+    Case 6
+        Call run("command6", 18)
+    Case 7
+        Call run("command7", 18)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch19()
+    Select Case command
+    Case 0
+        Call run("command0", 19)
+    Case 1
+        Call run("command1", 19)
+    Case 2
+        Call run("command2", 19)
+    Case 3
+        Call run("command3", 19)
+    Case 4
+        Call run("command4", 19)
+    Case 5
+        Call run("command5", 19)
+    Case 6
+        Call run("command6", 19)
+    Case 7
+        Call run("command7", 19)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch20()
+    Select Case command
+    Case 0
+        Call run("command0", 20)
+    Case 1
+        Call run("command1", 20)
+    Case 2
+        Call run("command2", 20)
+    Case 3
+        Call run("command3", 20)
+    Case 4
+        Call run("command4", 20)
+    Case 5
+        Call run("command5", 20)
+    Case 6
+        Call run("command6", 20)
+    Case 7
+        Call run("command7", 20)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch21()
+    Select Case command
+    Case 0
+        Call run("command0", 21)
+    Case 1
+        Call run("command1", 21)
+    Case 2
+        Call run("command2", 21)
+    Case 3
+        Call run("command3", 21)
+    Case 4
+        Call run("command4", 21)
+    Case 5
+        Call run("command5", 21)
+    Case 6
+        Call run("command6", 21)
+    Case 7
+        Call run("command7", 21)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch22()
+    Select Case command
+    Case 0
+        Call run("command0", 22)
+    Case 1
+        Call run("command1", 22)
+    Case 2
+        Call run("command2", 22)
+    Case 3
+        Call run("command3", 22)
+    Case 4
+        Call run("command4", 22)
+    Case 5
+        Call run("command5", 22)
+    Case 6
+        Call run("command6", 22)
+    Case 7
+        Call run("command7", 22)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch23()
+    Select Case command
+    Case 0
+        Call run("command0", 23)
+    Case 1
+        Call run("command1", 23)
+    Case 2
+        Call run("command2", 23)
+    Case 3
+        Call run("command3", 23)
+    Case 4
+        Call run("command4", 23)
+    Case 5
+        Call run("command5", 23)
+    Case 6
+        Call run("command6", 23)
+    Case 7
+        Call run("command7", 23)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch24()
+    Select Case command
+    Case 0
+        Call run("command0", 24)
+    Case 1
+        Call run("command1", 24)
+    Case 2
+        Call run("command2", 24)
+    Case 3
+        Call run("command3", 24)
+    Case 4
+        Call run("command4", 24)
+    Case 5
+        Call run("command5", 24)
+    Case 6
+        Call run("command6", 24)
+    Case 7
+        Call run("command7", 24)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch25()
+    Select Case command
+    Case 0
+        Call run("command0", 25)
+    Case 1
+        Call run("command1", 25)
+    Case 2
+        Call run("command2", 25)
+    Case 3
+        Call run("command3", 25)
+    Case 4
+        Call run("command4", 25)
+    Case 5
+        Call run("command5", 25)
+    Case 6
+        Call run("command6", 25)
+    Case 7
+        Call run("command7", 25)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch26()
+    Select Case command
+    Case 0
+        Call run("command0", 26)
+    Case 1
+        Call run("command1", 26)
+    Case 2
+        Call run("command2", 26)
+    Case 3
+        Call run("command3", 26)
+    Case 4
+        Call run("command4", 26)
+    Case 5
+        Call run("command5", 26)
+    Case 6
+        Call run("command6", 26)
+    Case 7
+        Call run("command7", 26)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch27()
+    Select Case command
+    Case 0
+        Call run("command0", 27)
+    Case 1
+        Call run("command1", 27)
+    Case 2
+        Call run("command2", 27)
+    Case 3
+        Call run("command3", 27)
+    Case 4
+        Call run("command4", 27)
+    Case 5
+        Call run("command5", 27)
+    Case 6
+        Call run("command6", 27)
+    Case 7
+        Call run("command7", 27)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch28()
+    Select Case command
+    Case 0
+        Call run("command0", 28)
+    Case 1
+        Call run("command1", 28)
+    Case 2
+        Call run("command2", 28)
+    Case 3
+        Call run("command3", 28)
+    Case 4
+        Call run("command4", 28)
+    Case 5
+        Call run("command5", 28)
+    Case 6
+        Call run("command6", 28)
+    Case 7
+        Call run("command7", 28)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
+Sub dispatch29()
+    Select Case command
+    Case 0
+        Call run("command0", 29)
+    Case 1
+        Call run("command1", 29)
+    Case 2
+        Call run("command2", 29)
+    Case 3
+        Call run("command3", 29)
+    Case 4
+        Call run("command4", 29)
+    Case 5
+        Call run("command5", 29)
+    Case 6
+        Call run("command6", 29)
+    Case 7
+        Call run("command7", 29)
+    End Select
+    GoTo done
+    Exit Sub
+End Sub
+
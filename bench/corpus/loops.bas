@@ -0,0 +1,633 @@
+Attribute VB_Name = "loops"
+Option Explicit
+
+Sub scan0()
+    For i = 1 To 10
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan1()
+    For i = 1 To 11
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan2()
+    For i = 1 To 12
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan3()
+    For i = 1 To 13
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan4()
+    For i = 1 To 14
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan5()
+    For i = 1 To 15
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan6()
+    For i = 1 To 16
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan7()
+    For i = 1 To 17
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan8()
+    For i = 1 To 18
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan9()
+    For i = 1 To 19
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan10()
+    For i = 1 To 20
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan11()
+    For i = 1 To 21
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan12()
+    For i = 1 To 22
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan13()
+    For i = 1 To 23
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan14()
+    For i = 1 To 24
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan15()
+    For i = 1 To 25
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan16()
+    For i = 1 To 26
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan17()
+    For i = 1 To 27
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan18()
+    For i = 1 To 28
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan19()
+    For i = 1 To 29
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan20()
+    For i = 1 To 30
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan21()
+    For i = 1 To 31
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan22()
+    For i = 1 To 32
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan23()
+    For i = 1 To 33
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan24()
+    For i = 1 To 34
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan25()
+    For i = 1 To 35
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan26()
+    For i = 1 To 36
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan27()
+    For i = 1 To 37
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan28()
+    For i = 1 To 38
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
+Sub scan29()
+    For i = 1 To 39
+        total = sum(total, i)
+        is_done = check(i)
+    Next i
+    For j = 0 To 100 Step 2
+        Call visit(j)
+        Exit For
+    Next
+    Do While pending
+        pending = fetch(queue)
+    Loop
+    Do
+        retries = retries
+        Exit Do
+    Loop Until ready
+    While waiting
+        waiting = poll(2.5)
+    Wend
+End Sub
+
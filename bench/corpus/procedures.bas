@@ -0,0 +1,603 @@
+Attribute VB_Name = "procedures"
+Option Explicit
+
+' handler number 0
+Sub handler0()
+    On Error GoTo 0
+    counter = 0
+    total = compute0(counter, "step")
+    Call notify("handler0", 0, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute0() As Long
+    On Error Resume Next
+    compute0 = 0
+End Function
+
+' handler number 1
+Private Sub handler1()
+    On Error GoTo 0
+    counter = 1
+    total = compute1(counter, "step")
+    Call notify("handler1", 1, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute1() As Long
+    On Error Resume Next
+    compute1 = 3
+End Function
+
+' handler number 2
+Sub handler2()
+    On Error GoTo 0
+    counter = 2
+    total = compute2(counter, "step")
+    Call notify("handler2", 2, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute2() As Long
+    On Error Resume Next
+    compute2 = 6
+End Function
+
+' handler number 3
+Private Sub handler3()
+    On Error GoTo 0
+    counter = 3
+    total = compute3(counter, "step")
+    Call notify("handler3", 3, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute3() As Long
+    On Error Resume Next
+    compute3 = 9
+End Function
+
+' handler number 4
+Sub handler4()
+    On Error GoTo 0
+    counter = 4
+    total = compute4(counter, "step")
+    Call notify("handler4", 4, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute4() As Long
+    On Error Resume Next
+    compute4 = 12
+End Function
+
+' handler number 5
+Private Sub handler5()
+    On Error GoTo 0
+    counter = 5
+    total = compute5(counter, "step")
+    Call notify("handler5", 5, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute5() As Long
+    On Error Resume Next
+    compute5 = 15
+End Function
+
+' handler number 6
+Sub handler6()
+    On Error GoTo 0
+    counter = 6
+    total = compute6(counter, "step")
+    Call notify("handler6", 6, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute6() As Long
+    On Error Resume Next
+    compute6 = 18
+End Function
+
+' handler number 7
+Private Sub handler7()
+    On Error GoTo 0
+    counter = 7
+    total = compute7(counter, "step")
+    Call notify("handler7", 7, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute7() As Long
+    On Error Resume Next
+    compute7 = 21
+End Function
+
+' handler number 8
+Sub handler8()
+    On Error GoTo 0
+    counter = 8
+    total = compute8(counter, "step")
+    Call notify("handler8", 8, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute8() As Long
+    On Error Resume Next
+    compute8 = 24
+End Function
+
+' handler number 9
+Private Sub handler9()
+    On Error GoTo 0
+    counter = 9
+    total = compute9(counter, "step")
+    Call notify("handler9", 9, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute9() As Long
+    On Error Resume Next
+    compute9 = 27
+End Function
+
+' handler number 10
+Sub handler10()
+    On Error GoTo 0
+    counter = 10
+    total = compute10(counter, "step")
+    Call notify("handler10", 10, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute10() As Long
+    On Error Resume Next
+    compute10 = 30
+End Function
+
+' handler number 11
+Private Sub handler11()
+    On Error GoTo 0
+    counter = 11
+    total = compute11(counter, "step")
+    Call notify("handler11", 11, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute11() As Long
+    On Error Resume Next
+    compute11 = 33
+End Function
+
+' handler number 12
+Sub handler12()
+    On Error GoTo 0
+    counter = 12
+    total = compute12(counter, "step")
+    Call notify("handler12", 12, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute12() As Long
+    On Error Resume Next
+    compute12 = 36
+End Function
+
+' handler number 13
+Private Sub handler13()
+    On Error GoTo 0
+    counter = 13
+    total = compute13(counter, "step")
+    Call notify("handler13", 13, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute13() As Long
+    On Error Resume Next
+    compute13 = 39
+End Function
+
+' handler number 14
+Sub handler14()
+    On Error GoTo 0
+    counter = 14
+    total = compute14(counter, "step")
+    Call notify("handler14", 14, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute14() As Long
+    On Error Resume Next
+    compute14 = 42
+End Function
+
+' handler number 15
+Private Sub handler15()
+    On Error GoTo 0
+    counter = 15
+    total = compute15(counter, "step")
+    Call notify("handler15", 15, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute15() As Long
+    On Error Resume Next
+    compute15 = 45
+End Function
+
+' handler number 16
+Sub handler16()
+    On Error GoTo 0
+    counter = 16
+    total = compute16(counter, "step")
+    Call notify("handler16", 16, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute16() As Long
+    On Error Resume Next
+    compute16 = 48
+End Function
+
+' handler number 17
+Private Sub handler17()
+    On Error GoTo 0
+    counter = 17
+    total = compute17(counter, "step")
+    Call notify("handler17", 17, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute17() As Long
+    On Error Resume Next
+    compute17 = 51
+End Function
+
+' handler number 18
+Sub handler18()
+    On Error GoTo 0
+    counter = 18
+    total = compute18(counter, "step")
+    Call notify("handler18", 18, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute18() As Long
+    On Error Resume Next
+    compute18 = 54
+End Function
+
+' handler number 19
+Private Sub handler19()
+    On Error GoTo 0
+    counter = 19
+    total = compute19(counter, "step")
+    Call notify("handler19", 19, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute19() As Long
+    On Error Resume Next
+    compute19 = 57
+End Function
+
+' handler number 20
+Sub handler20()
+    On Error GoTo 0
+    counter = 20
+    total = compute20(counter, "step")
+    Call notify("handler20", 20, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute20() As Long
+    On Error Resume Next
+    compute20 = 60
+End Function
+
+' handler number 21
+Private Sub handler21()
+    On Error GoTo 0
+    counter = 21
+    total = compute21(counter, "step")
+    Call notify("handler21", 21, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute21() As Long
+    On Error Resume Next
+    compute21 = 63
+End Function
+
+' handler number 22
+Sub handler22()
+    On Error GoTo 0
+    counter = 22
+    total = compute22(counter, "step")
+    Call notify("handler22", 22, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute22() As Long
+    On Error Resume Next
+    compute22 = 66
+End Function
+
+' handler number 23
+Private Sub handler23()
+    On Error GoTo 0
+    counter = 23
+    total = compute23(counter, "step")
+    Call notify("handler23", 23, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute23() As Long
+    On Error Resume Next
+    compute23 = 69
+End Function
+
+' handler number 24
+Sub handler24()
+    On Error GoTo 0
+    counter = 24
+    total = compute24(counter, "step")
+    Call notify("handler24", 24, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute24() As Long
+    On Error Resume Next
+    compute24 = 72
+End Function
+
+' handler number 25
+Private Sub handler25()
+    On Error GoTo 0
+    counter = 25
+    total = compute25(counter, "step")
+    Call notify("handler25", 25, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute25() As Long
+    On Error Resume Next
+    compute25 = 75
+End Function
+
+' handler number 26
+Sub handler26()
+    On Error GoTo 0
+    counter = 26
+    total = compute26(counter, "step")
+    Call notify("handler26", 26, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute26() As Long
+    On Error Resume Next
+    compute26 = 78
+End Function
+
+' handler number 27
+Private Sub handler27()
+    On Error GoTo 0
+    counter = 27
+    total = compute27(counter, "step")
+    Call notify("handler27", 27, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute27() As Long
+    On Error Resume Next
+    compute27 = 81
+End Function
+
+' handler number 28
+Sub handler28()
+    On Error GoTo 0
+    counter = 28
+    total = compute28(counter, "step")
+    Call notify("handler28", 28, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute28() As Long
+    On Error Resume Next
+    compute28 = 84
+End Function
+
+' handler number 29
+Private Sub handler29()
+    On Error GoTo 0
+    counter = 29
+    total = compute29(counter, "step")
+    Call notify("handler29", 29, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute29() As Long
+    On Error Resume Next
+    compute29 = 87
+End Function
+
+' handler number 30
+Sub handler30()
+    On Error GoTo 0
+    counter = 30
+    total = compute30(counter, "step")
+    Call notify("handler30", 30, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute30() As Long
+    On Error Resume Next
+    compute30 = 90
+End Function
+
+' handler number 31
+Private Sub handler31()
+    On Error GoTo 0
+    counter = 31
+    total = compute31(counter, "step")
+    Call notify("handler31", 31, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute31() As Long
+    On Error Resume Next
+    compute31 = 93
+End Function
+
+' handler number 32
+Sub handler32()
+    On Error GoTo 0
+    counter = 32
+    total = compute32(counter, "step")
+    Call notify("handler32", 32, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute32() As Long
+    On Error Resume Next
+    compute32 = 96
+End Function
+
+' handler number 33
+Private Sub handler33()
+    On Error GoTo 0
+    counter = 33
+    total = compute33(counter, "step")
+    Call notify("handler33", 33, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute33() As Long
+    On Error Resume Next
+    compute33 = 99
+End Function
+
+' handler number 34
+Sub handler34()
+    On Error GoTo 0
+    counter = 34
+    total = compute34(counter, "step")
+    Call notify("handler34", 34, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute34() As Long
+    On Error Resume Next
+    compute34 = 102
+End Function
+
+' handler number 35
+Private Sub handler35()
+    On Error GoTo 0
+    counter = 35
+    total = compute35(counter, "step")
+    Call notify("handler35", 35, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute35() As Long
+    On Error Resume Next
+    compute35 = 105
+End Function
+
+' handler number 36
+Sub handler36()
+    On Error GoTo 0
+    counter = 36
+    total = compute36(counter, "step")
+    Call notify("handler36", 36, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute36() As Long
+    On Error Resume Next
+    compute36 = 108
+End Function
+
+' handler number 37
+Private Sub handler37()
+    On Error GoTo 0
+    counter = 37
+    total = compute37(counter, "step")
+    Call notify("handler37", 37, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute37() As Long
+    On Error Resume Next
+    compute37 = 111
+End Function
+
+' handler number 38
+Sub handler38()
+    On Error GoTo 0
+    counter = 38
+    total = compute38(counter, "step")
+    Call notify("handler38", 38, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute38() As Long
+    On Error Resume Next
+    compute38 = 114
+End Function
+
+' handler number 39
+Private Sub handler39()
+    On Error GoTo 0
+    counter = 39
+    total = compute39(counter, "step")
+    Call notify("handler39", 39, total)
+    ReDim Preserve buffer(10)
+    Exit Sub
+End Sub
+
+Function compute39() As Long
+    On Error Resume Next
+    compute39 = 117
+End Function
+
@@ -0,0 +1,360 @@
+//: vb6_parser_bench.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "bench_helper.hpp"
+#include "vb6_alloc_hook.hpp"
+#include "vb6_ast_memory.hpp"
+#include "vb6_config.hpp"
+#include "vb6_coverage.hpp"
+#include "vb6_parser.hpp"
+#include "vb6_parser_api.hpp"
+#include "vb6_lazy_module.hpp"
+#include "vb6_line_index.hpp"
+#include "vb6_outline.hpp"
+#include "vb6_piece_table.hpp"
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+namespace x3 = boost::spirit::x3;
+
+// lines as found in half-migrated code, every one of them trips an expectation
+vector<string> make_error_dense_lines(size_t count)
+{
+  static char const* const samples[] = {
+    "Exit Foo\r\n",
+    "GoTo 100\r\n",
+    "ReDim arr 10\r\n",
+    "ReDim arr(10\r\n",
+    "On Eror GoTo 0\r\n",
+    "On Error Resume\r\n",
+    "Select x\r\n",
+  };
+
+  vector<string> lines;
+  lines.reserve(count);
+  for(size_t i = 0; i < count; ++i)
+    lines.emplace_back(samples[i % size(samples)]);
+  return lines;
+}
+
+size_t total_size(vector<string> const& lines)
+{
+  size_t sz = 0;
+  for(auto& l : lines)
+    sz += l.size();
+  return sz;
+}
+
+// parses every line on its own, as a linter checking line by line would do
+size_t parse_lines(vector<string> const& lines, vb6_grammar::expectation_policy policy)
+{
+  size_t failures = 0;
+
+  for(string_view line : lines)
+  {
+    auto it1 = cbegin(line);
+    auto const it2 = cend(line);
+
+    stringstream out;
+    vb6_grammar::error_handler_type error_handler(it1, it2, out, "bench.bas");
+    error_handler.policy(policy);
+
+    auto const parser = x3::with<vb6_grammar::vb6_error_handler_tag>(std::ref(error_handler))
+                        [
+                          vb6_grammar::statements::singleStmt
+                        ];
+
+    vb6_ast::statements::singleStmt ast;
+    try
+    {
+      if(!x3::phrase_parse(it1, it2, parser, vb6_grammar::skip, ast))
+        ++failures;
+    }
+    catch(x3::expectation_failure<vb6_grammar::iterator_type>&)
+    {
+      ++failures;
+    }
+  }
+
+  return failures;
+}
+
+// a well formed module, made of what the grammar fully supports for now
+string make_module(size_t nr_subs)
+{
+  string unit = "Option Explicit\r\n";
+  for(size_t i = 0; i < nr_subs; ++i)
+  {
+    auto const n = to_string(i);
+    unit += "' procedure number " + n + "\r\n"
+            "Sub foo" + n + "()\r\n"
+            "    On Error GoTo 0\r\n"
+            "    x = y\r\n"
+            "    counter = " + n + "\r\n"
+            "    Call bar(\"item\", " + n + ", counter)\r\n"
+            "    ReDim Preserve arr(10)\r\n"
+            "    GoTo label1\r\n"
+            "    Exit Sub\r\n"
+            "End Sub\r\n";
+  }
+  return unit;
+}
+
+// The benchmarks are meant to time a complete parse, one of an input that
+// stops early times the failure path instead. Tells on stderr where it stopped.
+bool parses_fully(string_view unit, string_view name)
+{
+  vb6_ast::vb_module ast;
+  auto const result = vb6_grammar::phrase_parse_module(unit, ast);
+  if(result.status == vb6_grammar::parse_status::ok)
+    return true;
+
+  cerr << name << ": the input does not parse";
+  if(!result.diagnostics.empty())
+  {
+    auto& d = result.diagnostics.front();
+    cerr << " (" << d.where.line << ':' << d.where.column << ": expecting " << d.which << ')';
+  }
+  cerr << '\n';
+  return false;
+}
+
+// the results of the benchmarks named prefix... are marked as parsed or not
+void mark_parsed(vector<bench_result>& results, string_view prefix, bool parsed)
+{
+  for(auto& r : results)
+  {
+    if(r.name.starts_with(prefix))
+      r.parsed = parsed;
+  }
+}
+
+string read_file(filesystem::path const& fname)
+{
+  ifstream in(fname, ios::binary);
+  return { istreambuf_iterator<char>(in), istreambuf_iterator<char>() };
+}
+
+// Usage: vb6_parser_bench [--corpus <dir>] [--json <file>]
+//                         [--baseline <file> [--threshold <percent>]] [--coverage]
+// The .bas files of the corpus directory are benchmarked next to the
+// synthetic workloads. --coverage counts the alternatives of the grammar
+// used by one parse of the synthetic module and of each corpus file.
+// With a baseline the exit code is 1 if any benchmark got slower, or
+// allocates more, by more than the threshold (10% by default), allocates
+// where it did not, is missing from the baseline, did not parse its input
+// or was not counted by the allocation hook when the baseline was.
+int main(int argc, char* argv[])
+{
+  string corpus_dir;
+  string json_file;
+  string baseline_file;
+  double threshold = 10.0;
+  bool coverage = false;
+
+  for(int i = 1; i < argc; ++i)
+  {
+    string_view const arg = argv[i];
+    if(arg == "--coverage")
+    {
+      coverage = true;
+      continue;
+    }
+    if(i + 1 == argc)
+    {
+      cerr << "Missing value for " << arg << '\n';
+      return 2;
+    }
+    if(arg == "--corpus")
+      corpus_dir = argv[++i];
+    else if(arg == "--json")
+      json_file = argv[++i];
+    else if(arg == "--baseline")
+      baseline_file = argv[++i];
+    else if(arg == "--threshold")
+      threshold = stod(argv[++i]);
+    else
+    {
+      cerr << "Unknown argument " << arg << '\n';
+      return 2;
+    }
+  }
+
+  vector<bench_result> results;
+
+  auto const lines = make_error_dense_lines(1000);
+  auto const bytes = total_size(lines);
+
+  results.push_back(run_bench("error_dense/throw_failure", bytes, [&] {
+    parse_lines(lines, vb6_grammar::expectation_policy::throw_failure);
+  }));
+  results.push_back(run_bench("error_dense/diagnose", bytes, [&] {
+    parse_lines(lines, vb6_grammar::expectation_policy::diagnose);
+  }));
+
+  // single statements, as typed in an immediate window
+  vector<string> snippets;
+  for(size_t i = 0; i < 1000; ++i)
+    snippets.push_back(i % 2 ? "x = y\r\n" : "Call bar(\"item\", " + to_string(i) + ", counter)\r\n");
+  auto const snippet_bytes = total_size(snippets);
+
+  results.push_back(run_bench("snippets/phrase_parse", snippet_bytes, [&] {
+    for(auto& snippet : snippets)
+    {
+      vb6_ast::statements::statement_block ast;
+      vb6_grammar::phrase_parse_statements(snippet, ast);
+    }
+  }));
+  results.push_back(run_bench("snippets/session", snippet_bytes, [&] {
+    vb6_grammar::parse_session session;
+    for(auto& snippet : snippets)
+      session.parse_statements(snippet);
+  }));
+  mark_parsed(results, "snippets/", all_of(begin(snippets), end(snippets), [](string const& snippet) {
+    vb6_ast::statements::statement_block ast;
+    return vb6_grammar::phrase_parse_statements(snippet, ast).status == vb6_grammar::parse_status::ok;
+  }));
+
+  auto const unit = make_module(200);
+
+  results.push_back(run_bench("module/full_ast", unit.size(), [&] {
+    vb6_ast::vb_module ast;
+    vb6_grammar::phrase_parse_module(unit, ast);
+  }));
+  results.push_back(run_bench("module/full_ast_spans", unit.size(), [&] {
+    vb6_ast::vb_module ast;
+    vb6_grammar::span_table spans;
+    vb6_grammar::phrase_parse_module(unit, ast, spans);
+  }));
+  // as an editor would hold the module: in blocks, or a piece per line
+  vb6_grammar::piece_text blocks;
+  for(size_t pos = 0; pos < unit.size(); pos += 4096)
+    blocks.append(string_view(unit).substr(pos, 4096));
+  vb6_grammar::piece_text line_pieces;
+  for(size_t pos = 0; pos < unit.size();)
+  {
+    auto const eol = min(unit.find('\n', pos), unit.size() - 1) + 1;
+    line_pieces.append(string_view(unit).substr(pos, eol - pos));
+    pos = eol;
+  }
+
+  results.push_back(run_bench("module/piece_table_4k", unit.size(), [&] {
+    vb6_ast::vb_module ast;
+    vb6_grammar::phrase_parse_module(blocks, ast);
+  }));
+  results.push_back(run_bench("module/piece_table_lines", unit.size(), [&] {
+    vb6_ast::vb_module ast;
+    vb6_grammar::phrase_parse_module(line_pieces, ast);
+  }));
+  results.push_back(run_bench("module/check_syntax", unit.size(), [&] {
+    vb6_grammar::check_syntax(unit);
+  }));
+  results.push_back(run_bench("module/outline", unit.size(), [&] {
+    vb6_grammar::parse_outline(unit);
+  }));
+  results.push_back(run_bench("module/lazy_one_body", unit.size(), [&] {
+    vb6_grammar::lazy_module module(unit);
+    module.procedures().front().body();
+  }));
+
+  results.push_back(run_bench("module/line_index", unit.size(), [&] {
+    vb6_grammar::line_index lines(unit);
+  }));
+  mark_parsed(results, "module/", parses_fully(unit, "module"));
+
+  vb6_grammar::coverage_counters counters;
+  if(coverage)
+  {
+    vb6_ast::vb_module ast;
+    vb6_grammar::phrase_parse_module(unit, ast, counters);
+  }
+
+  if(!corpus_dir.empty())
+  {
+    vector<filesystem::path> files;
+    for(auto& entry : filesystem::directory_iterator(corpus_dir))
+    {
+      if(entry.is_regular_file() && entry.path().extension() == ".bas")
+        files.push_back(entry.path());
+    }
+    sort(begin(files), end(files)); // stable order for the baseline
+
+    for(auto& fname : files)
+    {
+      auto const source = read_file(fname);
+      if(coverage)
+      {
+        vb6_ast::vb_module ast;
+        vb6_grammar::phrase_parse_module(source, ast, counters);
+      }
+      auto const name = "corpus/" + fname.filename().string();
+      results.push_back(run_bench(name, source.size(), [&] {
+        vb6_ast::vb_module ast;
+        vb6_grammar::phrase_parse_module(source, ast);
+      }));
+      results.back().parsed = parses_fully(source, name);
+    }
+  }
+
+  print_bench_results(cout, results);
+
+  if(coverage)
+  {
+    cout << "\ngrammar coverage\n";
+    vb6_grammar::print_coverage_report(cout, counters);
+  }
+
+  if(!json_file.empty())
+  {
+    ofstream out(json_file);
+    write_bench_json(out, results);
+  }
+
+  int exit_code = 0;
+  if(!baseline_file.empty())
+  {
+    ifstream in(baseline_file);
+    if(!in)
+    {
+      cerr << "Cannot read the baseline " << baseline_file << '\n';
+      return 2;
+    }
+    auto const baseline = read_bench_json(in);
+
+    cout << "\nCompared with " << baseline_file << " (threshold " << threshold << "%)\n";
+    auto const regressions = compare_bench_results(cout, baseline, results, threshold);
+    if(regressions != 0)
+    {
+      cout << regressions << " failure(s)\n";
+      exit_code = 1;
+    }
+  }
+
+  // memory needed by a single parse of the module
+  vb6_grammar::unit_memory_report report;
+  vb6_ast::vb_module ast;
+  {
+    vb6_grammar::alloc_scope scope;
+    vb6_grammar::phrase_parse_module(unit, ast);
+    report.parse = scope.delta();
+  }
+  report.ast = vb6_grammar::measure_module(ast);
+
+  cout << '\n';
+  vb6_grammar::print_memory_report(cout, "module (full_ast)", report);
+
+  return exit_code;
+}
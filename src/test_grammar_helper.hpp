@@ -12,7 +12,7 @@
 #include <boost/spirit/home/x3.hpp>
 
 #include <iostream>
-#include <sstream>
+#include <ostream>
 #include <string_view>
 
 template <class ruleType, class attrType>
@@ -28,7 +28,9 @@ void test_grammar(std::ostream& os, std::string_view testName, ruleType rule,
 
   try
   {
-    std::stringstream out;
+    // the handler only writes from on_error, which no rule has, so one
+    // stream that discards does for every call
+    thread_local std::ostream out(nullptr);
 
     vb6_grammar::error_handler_type error_handler(it1, it2, out, "source.bas");
 
@@ -60,6 +62,8 @@ void test_grammar(std::ostream& os, std::string_view testName, ruleType rule,
   }
   catch(x3::expectation_failure<decltype(it1)>& e)
   {
-    os << tag_fail << " - " << e.what() << " - " << (e.where() - it1) << " - " << e.which() << '\n';
+    auto const pos = vb6_grammar::line_index(fragment).position(static_cast<std::size_t>(e.where() - cbegin(fragment)));
+    os << tag_fail << " - " << e.what() << " - " << (e.where() - it1) << " - " << e.which()
+       << " (line " << pos.line << ", column " << pos.column << ")\n";
   }
 }
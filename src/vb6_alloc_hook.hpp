@@ -0,0 +1,50 @@
+//: vb6_alloc_hook.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+// Replaces the global operator new/delete with the counting ones of
+// vb6_alloc_stats.hpp when VB6_ALLOC_HOOK is defined.
+// To be included by exactly one source file of an executable, never by the
+// library.
+
+#pragma once
+
+#include "vb6_alloc_stats.hpp"
+
+#ifdef VB6_ALLOC_HOOK
+
+#include <cstddef>
+#include <new>
+
+void* operator new(std::size_t size)
+{
+  if(auto ptr = vb6_grammar::counted_alloc(size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+  return vb6_grammar::counted_alloc(size);
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept
+{
+  return vb6_grammar::counted_alloc(size);
+}
+
+void operator delete(void* ptr) noexcept { vb6_grammar::counted_free(ptr); }
+void operator delete[](void* ptr) noexcept { vb6_grammar::counted_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { vb6_grammar::counted_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { vb6_grammar::counted_free(ptr); }
+void operator delete(void* ptr, std::nothrow_t const&) noexcept { vb6_grammar::counted_free(ptr); }
+void operator delete[](void* ptr, std::nothrow_t const&) noexcept { vb6_grammar::counted_free(ptr); }
+
+#endif
@@ -0,0 +1,92 @@
+//: vb6_alloc_stats.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_alloc_stats.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace vb6_grammar {
+
+namespace {
+
+// the requested size is stored in front of every block
+constexpr std::size_t header_size = alignof(std::max_align_t);
+
+thread_local alloc_counters counters;
+
+std::atomic<bool> hook_active = false;
+
+}
+
+void* counted_alloc(std::size_t size) noexcept
+{
+  auto const block = static_cast<unsigned char*>(std::malloc(size + header_size));
+  if(!block)
+    return nullptr;
+  std::memcpy(block, &size, sizeof(size));
+
+  if(!hook_active.load(std::memory_order_relaxed))
+    hook_active.store(true, std::memory_order_relaxed);
+
+  auto& c = counters;
+  ++c.allocations;
+  c.bytes += size;
+  c.live_bytes += size;
+  if(c.live_bytes > c.peak_bytes)
+    c.peak_bytes = c.live_bytes;
+
+  return block + header_size;
+}
+
+void counted_free(void* ptr) noexcept
+{
+  if(!ptr)
+    return;
+
+  auto const block = static_cast<unsigned char*>(ptr) - header_size;
+  std::size_t size;
+  std::memcpy(&size, block, sizeof(size));
+
+  auto& c = counters;
+  ++c.deallocations;
+  c.live_bytes = c.live_bytes >= size ? c.live_bytes - size : 0;
+
+  std::free(block);
+}
+
+alloc_counters const& thread_alloc_counters() noexcept
+{
+  return counters;
+}
+
+bool alloc_hook_active() noexcept
+{
+  return hook_active.load(std::memory_order_relaxed);
+}
+
+alloc_scope::alloc_scope() noexcept
+  : start(counters)
+{
+  counters.peak_bytes = counters.live_bytes;
+  start.peak_bytes = counters.live_bytes;
+}
+
+alloc_counters alloc_scope::delta() const noexcept
+{
+  auto const& now = counters;
+
+  alloc_counters d;
+  d.allocations = now.allocations - start.allocations;
+  d.deallocations = now.deallocations - start.deallocations;
+  d.bytes = now.bytes - start.bytes;
+  d.live_bytes = now.live_bytes > start.live_bytes ? now.live_bytes - start.live_bytes : 0;
+  d.peak_bytes = now.peak_bytes > start.peak_bytes ? now.peak_bytes - start.peak_bytes : 0;
+  return d;
+}
+
+}
@@ -0,0 +1,47 @@
+//: vb6_alloc_stats.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <cstddef>
+
+namespace vb6_grammar {
+
+  // what the current thread has allocated through the counting hook
+  struct alloc_counters
+  {
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t bytes = 0;      // requested, in total
+    std::size_t live_bytes = 0; // requested and not freed yet
+    std::size_t peak_bytes = 0; // highest live_bytes
+  };
+
+  // Counted replacements of malloc/free, to be called by a global operator
+  // new/delete (see vb6_alloc_hook.hpp). Memory freed by another thread than
+  // the one that allocated it is subtracted from the freeing thread.
+  void* counted_alloc(std::size_t size) noexcept;
+  void counted_free(void* ptr) noexcept;
+
+  alloc_counters const& thread_alloc_counters() noexcept;
+
+  // true once counted_alloc has been called, that is if the hook is installed
+  bool alloc_hook_active() noexcept;
+
+  // Counts what gets allocated by this thread from its construction on.
+  // The peak is the highest amount of memory allocated in the meantime and
+  // not freed, scopes must not be nested.
+  class alloc_scope
+  {
+  public:
+    alloc_scope() noexcept;
+
+    alloc_counters delta() const noexcept;
+
+  private:
+    alloc_counters start;
+  };
+}
@@ -0,0 +1,233 @@
+//: vb6_archive.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_archive.hpp"
+#include "vb6_file_reader.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define VB6_ARCHIVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vb6_grammar {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char magic[8] = { 'V', 'B', '6', 'P', 'A', 'C', 'K', '\0' };
+constexpr std::uint32_t version = 1;
+constexpr std::size_t header_size = sizeof(magic) + 4 + 4 + 8;
+
+template <typename T>
+void put(std::ostream& os, T value)
+{
+  char bytes[sizeof(T)];
+  for(std::size_t i = 0; i < sizeof(T); ++i)
+    bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+  os.write(bytes, sizeof(T));
+}
+
+template <typename T>
+T get(char const* p)
+{
+  T value = 0;
+  for(std::size_t i = 0; i < sizeof(T); ++i)
+    value |= static_cast<T>(static_cast<unsigned char>(p[i])) << (8 * i);
+  return value;
+}
+
+std::string entry_name(fs::path const& file, std::vector<fs::path> const& bases)
+{
+  for(auto& base : bases)
+  {
+    auto const rel = file.lexically_normal().lexically_relative(base.lexically_normal());
+    if(!rel.empty() && *rel.begin() != "..")
+      return rel.generic_string();
+  }
+  return file.generic_string();
+}
+
+}
+
+std::vector<fs::path> archive_bases(std::vector<std::string> const& args)
+{
+  std::vector<fs::path> bases;
+  for(auto& arg : args)
+  {
+    fs::path const p = arg;
+    std::error_code ec;
+    if(fs::is_directory(p, ec))
+      bases.push_back(p);
+    else if(p.extension() == ".vbp")
+      bases.push_back(p.has_parent_path() ? p.parent_path() : fs::path("."));
+  }
+  return bases;
+}
+
+bool write_archive(fs::path const& archive, std::vector<fs::path> const& files, std::vector<fs::path> const& bases,
+                   std::ostream& err)
+{
+  std::ofstream out(archive, std::ios::binary);
+  if(!out)
+  {
+    err << "Could not create the archive: " << archive.string() << '\n';
+    return false;
+  }
+
+  struct index_entry
+  {
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::string name;
+  };
+  std::vector<index_entry> index;
+  index.reserve(files.size());
+
+  out.write(magic, sizeof(magic));
+  put<std::uint32_t>(out, version);
+  put<std::uint32_t>(out, 0); // the count and the index offset come at the end
+  put<std::uint64_t>(out, 0);
+
+  std::uint64_t offset = header_size;
+  std::string contents;
+  bool ok = true;
+  for(auto& f : files)
+  {
+    if(!read_file(f, contents))
+    {
+      err << "Could not read: " << f.string() << '\n';
+      ok = false;
+      continue;
+    }
+    out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    index.push_back({ offset, contents.size(), entry_name(f, bases) });
+    offset += contents.size();
+  }
+
+  for(auto& e : index)
+  {
+    put<std::uint64_t>(out, e.offset);
+    put<std::uint64_t>(out, e.size);
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(e.name.size()));
+    out.write(e.name.data(), static_cast<std::streamsize>(e.name.size()));
+  }
+
+  out.seekp(sizeof(magic) + 4);
+  put<std::uint32_t>(out, static_cast<std::uint32_t>(index.size()));
+  put<std::uint64_t>(out, offset);
+
+  if(!out.flush())
+  {
+    err << "Could not write the archive: " << archive.string() << '\n';
+    return false;
+  }
+  return ok;
+}
+
+archive_view::archive_view(fs::path const& archive)
+{
+#ifdef VB6_ARCHIVE_MMAP
+  auto const fd = ::open(archive.c_str(), O_RDONLY | O_CLOEXEC);
+  if(fd < 0)
+  {
+    error_text = "Could not open the archive: " + archive.string();
+    return;
+  }
+  struct stat st{};
+  if(::fstat(fd, &st) == 0 && st.st_size > 0)
+  {
+    length = static_cast<std::size_t>(st.st_size);
+    auto const p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(p != MAP_FAILED)
+    {
+      data = static_cast<char const*>(p);
+      // read front to back by the loader
+      ::madvise(p, length, MADV_SEQUENTIAL);
+    }
+    else
+      length = 0;
+  }
+  ::close(fd);
+  if(!data)
+  {
+    error_text = "Could not map the archive: " + archive.string();
+    return;
+  }
+#else
+  if(!read_file(archive, buffer))
+  {
+    error_text = "Could not read the archive: " + archive.string();
+    return;
+  }
+  data = buffer.data();
+  length = buffer.size();
+#endif
+  read_index();
+  if(!ok())
+    error_text += ": " + archive.string();
+}
+
+archive_view::~archive_view()
+{
+#ifdef VB6_ARCHIVE_MMAP
+  if(data)
+    ::munmap(const_cast<char*>(data), length);
+#endif
+}
+
+void archive_view::read_index()
+{
+  if(length < header_size || std::memcmp(data, magic, sizeof(magic)) != 0)
+  {
+    error_text = "Not an archive";
+    return;
+  }
+  if(get<std::uint32_t>(data + 8) != version)
+  {
+    error_text = "Unsupported archive version";
+    return;
+  }
+
+  auto const count = get<std::uint32_t>(data + 12);
+  auto pos = get<std::uint64_t>(data + 16);
+  // every entry takes at least 20 bytes of index, so a count that cannot
+  // fit is corrupt and must not size the reservation
+  if(pos > length || count > (length - pos) / 20)
+  {
+    error_text = "Corrupted archive index";
+    return;
+  }
+  entries.reserve(count);
+  for(std::uint32_t i = 0; i < count; ++i)
+  {
+    if(pos > length || length - pos < 20)
+      break;
+    auto const offset = get<std::uint64_t>(data + pos);
+    auto const size = get<std::uint64_t>(data + pos + 8);
+    auto const name_size = get<std::uint32_t>(data + pos + 16);
+    pos += 20;
+    if(name_size > length - pos || offset > length || size > length - offset)
+      break;
+    entries.push_back({ std::string_view(data + pos, name_size), std::string_view(data + offset, size) });
+    pos += name_size;
+  }
+  if(entries.size() != count)
+  {
+    entries.clear();
+    error_text = "Corrupted archive index";
+  }
+}
+
+}
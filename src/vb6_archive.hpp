@@ -0,0 +1,74 @@
+//: vb6_archive.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+// A corpus packed in one file, so that parsing thousands of small units takes
+// one open and one mapping instead of an open, a read and a close each.
+//
+//   header   "VB6PACK" '\0', version (u32), entry count (u32), index offset (u64)
+//   contents of the files back to back
+//   index    per entry: offset (u64), size (u64), name size (u32), name
+//
+// Numbers are little endian, offsets from the beginning of the archive.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vb6_grammar {
+
+  inline constexpr std::string_view archive_extension = ".vb6pack";
+
+  // Packs the files, each one named by its path relative to the first of bases
+  // it is inside of, else as given. Problems are reported to err.
+  bool write_archive(std::filesystem::path const& archive, std::vector<std::filesystem::path> const& files,
+                     std::vector<std::filesystem::path> const& bases, std::ostream& err);
+
+  // What the files collected from args get named relative to: the directories
+  // among them and the ones of the .vbp projects, in order.
+  std::vector<std::filesystem::path> archive_bases(std::vector<std::string> const& args);
+
+  // An archive mapped in memory, the names and contents point into it.
+  class archive_view
+  {
+  public:
+    struct entry
+    {
+      std::string_view name;
+      std::string_view contents;
+    };
+
+    explicit archive_view(std::filesystem::path const& archive);
+    ~archive_view();
+
+    archive_view(archive_view const&) = delete;
+    archive_view& operator=(archive_view const&) = delete;
+
+    // false if it could not be mapped or is not a valid archive, see error()
+    bool ok() const { return error_text.empty(); }
+    std::string const& error() const { return error_text; }
+
+    std::size_t size() const { return entries.size(); }
+    entry const& operator[](std::size_t i) const { return entries[i]; }
+
+    std::vector<entry>::const_iterator begin() const { return entries.begin(); }
+    std::vector<entry>::const_iterator end() const { return entries.end(); }
+
+  private:
+    void read_index();
+
+    char const* data = nullptr;
+    std::size_t length = 0;
+    std::string buffer; // the archive when it cannot be mapped
+    std::vector<entry> entries;
+    std::string error_text;
+  };
+}
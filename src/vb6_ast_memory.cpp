@@ -0,0 +1,62 @@
+//: vb6_ast_memory.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_ast_memory.hpp"
+
+#include <iomanip>
+#include <ostream>
+
+namespace vb6_grammar {
+
+module_memory measure_module(vb6_ast::vb_module const& ast)
+{
+  module_memory mem;
+
+  // the vector of the items
+  mem.others.blocks += ast.capacity() != 0;
+  mem.others.bytes += ast.capacity() * sizeof(vb6_ast::vb_module::value_type);
+
+  for(auto& item : ast)
+  {
+    boost::apply_visitor([&mem](auto const& node) {
+      using node_type = std::decay_t<decltype(node)>;
+      if constexpr(std::is_same_v<node_type, vb6_ast::declaration>)
+        mem.declarations += measure_ast(node);
+      else if constexpr(std::is_same_v<node_type, vb6_ast::subDef>)
+        mem.subs += measure_ast(node);
+      else if constexpr(std::is_same_v<node_type, vb6_ast::functionDef>)
+        mem.functions += measure_ast(node);
+      else
+        mem.others += measure_ast(node);
+    }, item.get());
+  }
+
+  return mem;
+}
+
+void print_memory_report(std::ostream& os, std::string_view unit_name, unit_memory_report const& report)
+{
+  auto line = [&os](std::string_view what, std::size_t blocks, std::size_t bytes) {
+    os << "  " << std::left << std::setw(20) << what << std::right
+       << std::setw(10) << blocks << " blocks" << std::setw(12) << bytes << " bytes\n";
+  };
+
+  os << "memory of " << unit_name << '\n';
+  if(alloc_hook_active())
+  {
+    line("parse allocations", report.parse.allocations, report.parse.bytes);
+    os << "  " << std::left << std::setw(20) << "parse peak" << std::right
+       << std::setw(36) << report.parse.peak_bytes << " bytes\n";
+  }
+  line("AST declaration", report.ast.declarations.blocks, report.ast.declarations.bytes);
+  line("AST subDef", report.ast.subs.blocks, report.ast.subs.bytes);
+  line("AST functionDef", report.ast.functions.blocks, report.ast.functions.bytes);
+  line("AST other", report.ast.others.blocks, report.ast.others.bytes);
+  auto const total = report.ast.total();
+  line("AST total", total.blocks, total.bytes);
+}
+
+}
@@ -0,0 +1,144 @@
+//: vb6_ast_memory.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include "vb6_alloc_stats.hpp"
+#include "vb6_ast.hpp"
+#include "vb6_ast_adapt.hpp"
+
+#include <boost/fusion/include/for_each.hpp>
+#include <boost/fusion/include/is_sequence.hpp>
+#include <boost/fusion/include/std_pair.hpp>
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace vb6_grammar {
+
+  // heap memory held by an AST (the nodes themselves excluded)
+  struct ast_memory
+  {
+    std::size_t blocks = 0;
+    std::size_t bytes = 0;
+
+    ast_memory& operator+=(ast_memory const& rhs)
+    {
+      blocks += rhs.blocks;
+      bytes += rhs.bytes;
+      return *this;
+    }
+  };
+
+  namespace detail {
+
+    template <typename T>
+    struct is_forward_ast : std::false_type {};
+    template <typename T>
+    struct is_forward_ast<boost::spirit::x3::forward_ast<T>> : std::true_type {};
+
+    // Walks the members as seen through the fusion adaptation, so members
+    // that are not adapted are not accounted for.
+    struct ast_memory_walker
+    {
+      ast_memory& mem;
+
+      template <typename T>
+      void operator()(T const& node) const
+      {
+        if constexpr(std::is_base_of_v<std::string, T>)
+        {
+          std::string const& str = node;
+          if(str.capacity() > std::string().capacity()) // not in the small buffer
+          {
+            ++mem.blocks;
+            mem.bytes += str.capacity() + 1;
+          }
+        }
+        else if constexpr(requires { typename T::value_type; requires std::is_base_of_v<std::vector<typename T::value_type>, T>; })
+        {
+          std::vector<typename T::value_type> const& vec = node;
+          if(vec.capacity() != 0)
+          {
+            ++mem.blocks;
+            mem.bytes += vec.capacity() * sizeof(typename T::value_type);
+          }
+          for(auto& elem : vec)
+            (*this)(elem);
+        }
+        else if constexpr(requires { typename T::variant_type; node.get(); })
+        {
+          boost::apply_visitor([this](auto const& alt) { (*this)(alt); }, node.get());
+        }
+        else if constexpr(is_forward_ast<T>::value)
+        {
+          ++mem.blocks;
+          mem.bytes += sizeof(node.get());
+          (*this)(node.get());
+        }
+        else if constexpr(requires { node.is_initialized(); *node; })
+        {
+          if(node)
+            (*this)(*node);
+        }
+        else if constexpr(std::is_same_v<T, vb6_ast::type_identifier>)
+        {
+          (*this)(node.library_or_module);
+          (*this)(node.nonnative_type);
+        }
+        else if constexpr(std::is_same_v<T, vb6_ast::statements::case_relational_expr>)
+        {
+          (*this)(node.rexpr);
+        }
+        else if constexpr(boost::fusion::traits::is_sequence<T>::value)
+        {
+          boost::fusion::for_each(node, *this);
+        }
+      }
+    };
+  }
+
+  template <typename Node>
+  ast_memory measure_ast(Node const& node)
+  {
+    ast_memory mem;
+    detail::ast_memory_walker{ mem }(node);
+    return mem;
+  }
+
+  // memory of a module split by kind of top level item
+  struct module_memory
+  {
+    ast_memory declarations;
+    ast_memory subs;
+    ast_memory functions;
+    ast_memory others; // comments, attributes, options
+
+    ast_memory total() const
+    {
+      ast_memory t = declarations;
+      t += subs;
+      t += functions;
+      t += others;
+      return t;
+    }
+  };
+
+  module_memory measure_module(vb6_ast::vb_module const& ast);
+
+  // allocations made while parsing a unit and what the resulting AST holds
+  struct unit_memory_report
+  {
+    alloc_counters parse; // all zeroes unless the counting hook is installed
+    module_memory ast;
+  };
+
+  void print_memory_report(std::ostream& os, std::string_view unit_name, unit_memory_report const& report);
+}
@@ -0,0 +1,233 @@
+//: vb6_ast_serialize.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_ast_serialize.hpp"
+#include "vb6_ast_adapt.hpp"
+
+#include <boost/fusion/include/at_c.hpp>
+#include <boost/fusion/include/for_each.hpp>
+#include <boost/fusion/include/is_sequence.hpp>
+#include <boost/fusion/include/size.hpp>
+#include <boost/fusion/include/std_pair.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vb6_grammar {
+
+namespace {
+
+template <typename T>
+struct is_forward_ast : std::false_type {};
+template <typename T>
+struct is_forward_ast<boost::spirit::x3::forward_ast<T>> : std::true_type {};
+
+template <typename T>
+constexpr bool is_vector = requires { typename T::value_type; requires std::is_base_of_v<std::vector<typename T::value_type>, T>; };
+
+template <typename T>
+constexpr bool is_x3_variant = requires(T const& node) { typename T::variant_type; node.get(); };
+
+template <typename T>
+constexpr bool is_optional = requires(T const& node) { node.is_initialized(); *node; };
+
+void write_json_string(std::ostream& os, std::string const& str)
+{
+  os << '"';
+  for(char c : str)
+  {
+    switch(c)
+    {
+    case '"':  os << "\\\""; break;
+    case '\\': os << "\\\\"; break;
+    case '\n': os << "\\n"; break;
+    case '\r': os << "\\r"; break;
+    case '\t': os << "\\t"; break;
+    default:
+      if(static_cast<unsigned char>(c) < 0x20)
+      {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+        os << buf;
+      }
+      else
+        os << c;
+    }
+  }
+  os << '"';
+}
+
+struct json_writer
+{
+  std::ostream& os;
+
+  template <typename T>
+  void operator()(T const& node) const
+  {
+    if constexpr(std::is_base_of_v<std::string, T>)
+      write_json_string(os, node);
+    else if constexpr(std::is_same_v<T, bool>)
+      os << (node ? "true" : "false");
+    else if constexpr(std::is_enum_v<T>)
+      os << static_cast<long long>(node);
+    else if constexpr(std::is_arithmetic_v<T>)
+      os << node;
+    else if constexpr(is_vector<T>)
+    {
+      os << '[';
+      bool first = true;
+      for(auto& elem : node)
+      {
+        if(!first)
+          os << ',';
+        (*this)(elem);
+        first = false;
+      }
+      os << ']';
+    }
+    else if constexpr(is_x3_variant<T>)
+      boost::apply_visitor([this](auto const& alt) { (*this)(alt); }, node.get());
+    else if constexpr(is_forward_ast<T>::value)
+      (*this)(node.get());
+    else if constexpr(is_optional<T>)
+    {
+      if(node)
+        (*this)(*node);
+      else
+        os << "null";
+    }
+    else if constexpr(std::is_same_v<T, vb6_ast::type_identifier>)
+    {
+      os << "{\"type\":" << static_cast<int>(node.type) << ",\"library_or_module\":";
+      (*this)(node.library_or_module);
+      os << ",\"nonnative_type\":";
+      (*this)(node.nonnative_type);
+      os << '}';
+    }
+    else if constexpr(std::is_same_v<T, vb6_ast::statements::case_relational_expr>)
+    {
+      os << "{\"rel_op\":" << static_cast<int>(node.rel_op) << ",\"rexpr\":";
+      (*this)(node.rexpr);
+      os << '}';
+    }
+    else if constexpr(boost::fusion::traits::is_sequence<T>::value)
+    {
+      os << '{';
+      members(node, std::make_index_sequence<boost::fusion::result_of::size<T>::value>());
+      os << '}';
+    }
+    else
+      os << "null";
+  }
+
+  template <typename T, std::size_t... I>
+  void members(T const& node, std::index_sequence<I...>) const
+  {
+    ((os << (I == 0 ? "\"" : ",\"") << boost::fusion::extension::struct_member_name<T, I>::call() << "\":",
+      (*this)(boost::fusion::at_c<I>(node))), ...);
+  }
+};
+
+struct binary_writer
+{
+  std::ostream& os;
+
+  void varint(std::uint64_t value) const
+  {
+    while(value >= 0x80)
+    {
+      os.put(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    os.put(static_cast<char>(value));
+  }
+
+  template <typename T>
+  void fixed(T value) const
+  {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    if constexpr(std::endian::native == std::endian::big)
+    {
+      for(std::size_t i = 0; i < sizeof(T) / 2; ++i)
+        std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+    }
+    os.write(bytes, sizeof(T));
+  }
+
+  template <typename T>
+  void operator()(T const& node) const
+  {
+    if constexpr(std::is_base_of_v<std::string, T>)
+    {
+      std::string const& str = node;
+      varint(str.size());
+      os.write(str.data(), static_cast<std::streamsize>(str.size()));
+    }
+    else if constexpr(std::is_same_v<T, bool>)
+      os.put(node ? 1 : 0);
+    else if constexpr(std::is_enum_v<T>)
+      varint(static_cast<std::uint64_t>(node));
+    else if constexpr(std::is_arithmetic_v<T>)
+      fixed(node);
+    else if constexpr(is_vector<T>)
+    {
+      varint(node.size());
+      for(auto& elem : node)
+        (*this)(elem);
+    }
+    else if constexpr(is_x3_variant<T>)
+    {
+      varint(static_cast<std::uint64_t>(node.get().which()));
+      boost::apply_visitor([this](auto const& alt) { (*this)(alt); }, node.get());
+    }
+    else if constexpr(is_forward_ast<T>::value)
+      (*this)(node.get());
+    else if constexpr(is_optional<T>)
+    {
+      os.put(node ? 1 : 0);
+      if(node)
+        (*this)(*node);
+    }
+    else if constexpr(std::is_same_v<T, vb6_ast::type_identifier>)
+    {
+      varint(static_cast<std::uint64_t>(node.type));
+      (*this)(node.library_or_module);
+      (*this)(node.nonnative_type);
+    }
+    else if constexpr(std::is_same_v<T, vb6_ast::statements::case_relational_expr>)
+    {
+      varint(static_cast<std::uint64_t>(node.rel_op));
+      (*this)(node.rexpr);
+    }
+    else if constexpr(boost::fusion::traits::is_sequence<T>::value)
+      boost::fusion::for_each(node, *this);
+  }
+};
+
+}
+
+void write_ast_json(std::ostream& os, vb6_ast::vb_module const& ast)
+{
+  json_writer{ os }(ast);
+  os << '\n';
+}
+
+void write_ast_binary(std::ostream& os, vb6_ast::vb_module const& ast)
+{
+  os.write("VB6A", 4);
+  os.put(1); // version
+  binary_writer{ os }(ast);
+}
+
+}
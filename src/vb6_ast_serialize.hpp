@@ -0,0 +1,25 @@
+//: vb6_ast_serialize.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include "vb6_ast.hpp"
+
+#include <iosfwd>
+
+namespace vb6_grammar {
+
+  // The AST as JSON: structures are objects keyed by the member names of
+  // vb6_ast_adapt.hpp, alternatives are written as the value they hold and
+  // enumerations as their number.
+  void write_ast_json(std::ostream& os, vb6_ast::vb_module const& ast);
+
+  // The AST in a compact binary form, the magic "VB6A" and a version byte
+  // followed by the nodes in the order of vb6_ast_adapt.hpp: sizes, enumerations
+  // and the index of the alternatives as LEB128 varints, optionals as a
+  // presence byte, numbers as little-endian values of their size.
+  void write_ast_binary(std::ostream& os, vb6_ast::vb_module const& ast);
+}
@@ -0,0 +1,1049 @@
+//: vb6_batch.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_batch.hpp"
+#include "cpp_ast_printer.hpp"
+#include "raw_ast_printer.hpp"
+#include "vb6_ast_printer.hpp"
+#include "vb6_ast_serialize.hpp"
+#include "vb6_bounded_queue.hpp"
+#include "vb6_file_reader.hpp"
+#include "vb6_line_index.hpp"
+#include "vb6_outline.hpp"
+#include "vb6_parser_api.hpp"
+#include "vb6_probes.hpp"
+#include "vb6_stream.hpp"
+#include "vb6_trace.hpp"
+#include "vb6_work_stealing.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+namespace vb6_grammar {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool iequals(std::string_view a, std::string_view b)
+{
+  return a.size() == b.size()
+      && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+bool is_source_file(fs::path const& p)
+{
+  auto const ext = p.extension().string();
+  return iequals(ext, ".bas") || iequals(ext, ".cls") || iequals(ext, ".frm") || iequals(ext, ".ctl");
+}
+
+// '*' matches any run of characters, '?' any single one
+bool wildcard_match(std::string_view pattern, std::string_view name)
+{
+  std::size_t p = 0, n = 0;
+  std::size_t star = std::string_view::npos, mark = 0;
+  while(n < name.size())
+  {
+    if(p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n]))
+    {
+      ++p;
+      ++n;
+    }
+    else if(p < pattern.size() && pattern[p] == '*')
+    {
+      star = p++;
+      mark = n;
+    }
+    else if(star != std::string_view::npos)
+    {
+      p = star + 1;
+      n = ++mark;
+    }
+    else
+      return false;
+  }
+  while(p < pattern.size() && pattern[p] == '*')
+    ++p;
+  return p == pattern.size();
+}
+
+std::string_view trim(std::string_view s)
+{
+  while(!s.empty() && std::isspace(static_cast<unsigned char>(s.front())))
+    s.remove_prefix(1);
+  while(!s.empty() && std::isspace(static_cast<unsigned char>(s.back())))
+    s.remove_suffix(1);
+  return s;
+}
+
+// Module=name; file.bas, Class=name; file.cls, Form=file.frm, UserControl=file.ctl
+std::vector<fs::path> project_units(fs::path const& vbp, std::ostream& err)
+{
+  std::vector<fs::path> units;
+  std::ifstream in(vbp);
+  if(!in)
+  {
+    err << "Could not open project: " << vbp.string() << '\n';
+    return units;
+  }
+
+  std::string line;
+  while(std::getline(in, line))
+  {
+    std::string_view const text = trim(line);
+    auto const eq = text.find('=');
+    if(eq == std::string_view::npos)
+      continue;
+    auto const key = text.substr(0, eq);
+    if(!iequals(key, "Module") && !iequals(key, "Class") && !iequals(key, "Form") && !iequals(key, "UserControl"))
+      continue;
+
+    auto value = text.substr(eq + 1);
+    if(auto const semi = value.rfind(';'); semi != std::string_view::npos)
+      value = value.substr(semi + 1);
+    std::string file(trim(value));
+    std::replace(file.begin(), file.end(), '\\', '/');
+    units.push_back(vbp.parent_path() / file);
+  }
+  return units;
+}
+
+std::uint64_t elapsed_ns(std::uint64_t start)
+{
+  return trace_clock() - start;
+}
+
+void print_ast(std::ostream& os, output_format format, vb6_ast::vb_module const& ast)
+{
+  switch(format)
+  {
+  case output_format::none:
+    break;
+  case output_format::vb:
+    vb6_ast_printer{ os }(ast);
+    break;
+  case output_format::cpp:
+    cpp_ast_printer{ os }(ast);
+    break;
+  case output_format::raw:
+    raw_ast_printer{ os }(ast);
+    break;
+  case output_format::json:
+    write_ast_json(os, ast);
+    break;
+  case output_format::binary:
+    write_ast_binary(os, ast);
+    break;
+  }
+}
+
+char const* status_name(parse_status status)
+{
+  switch(status)
+  {
+  case parse_status::ok: return "ok";
+  case parse_status::syntax_error: return "syntax error";
+  case parse_status::budget_exhausted: return "budget exhausted";
+  case parse_status::cancelled: return "cancelled";
+  }
+  return "?";
+}
+
+// a file parsed in pieces, by whichever parsing threads get to them
+struct split_parse
+{
+  std::vector<std::size_t> cuts; // piece i goes from cuts[i] to cuts[i + 1]
+  std::vector<vb6_ast::vb_module> asts;
+  std::vector<parse_result> results;
+  std::vector<std::uint64_t> ns;
+  std::vector<perf_sample> perf;
+  std::atomic<std::size_t> remaining = 0;
+};
+
+// what goes from one stage of the pipeline to the next
+struct batch_item
+{
+  std::size_t index = 0;
+  file_result res;
+  std::string storage;   // what was read, unless the source lives elsewhere
+  std::string_view unit; // the source
+  unit_layout layout;    // where its code is, found by the loader
+  vb6_ast::vb_module ast;
+  std::unique_ptr<split_parse> split;
+  std::size_t content = 0;   // files with the same bytes share it, see content_table
+  bool duplicate = false;    // of a file loaded earlier, not to be parsed
+};
+
+// a piece of a split file, the last piece to be parsed puts them together
+struct piece_task
+{
+  batch_item* item = nullptr;
+  std::size_t piece = 0;
+};
+
+// the counters of the calling thread, null unless asked for and available
+perf_counters* open_counters(batch_options const& options, std::optional<perf_counters>& counters)
+{
+  if(options.perf_counters)
+    counters.emplace();
+  return counters && counters->available() ? &*counters : nullptr;
+}
+
+// Once per file, by the loader: the parse then goes straight to the code,
+// whatever the kind of unit.
+void sniff_stage(batch_item& item)
+{
+  item.layout = sniff_unit(item.unit, item.res.name);
+  item.res.kind = item.layout.kind;
+}
+
+void load_stage(fs::path const& fname, batch_item& item, perf_counters* counters)
+{
+  auto& res = item.res;
+  res.name = fname.string();
+  res.perf.name = res.name;
+
+  trace_scope load("load", "io", res.name);
+  std::optional<perf_scope> perf;
+  if(counters)
+    perf.emplace(*counters, res.perf.load);
+  auto const start = trace_clock();
+  res.loaded = read_file(fname, item.storage);
+  item.unit = item.storage;
+  res.load_ns = elapsed_ns(start);
+  if(res.loaded)
+  {
+    res.bytes = item.unit.size();
+    sniff_stage(item);
+  }
+  else
+    res.errors = res.name + ": could not be read\n";
+}
+
+// the line the command line prints, "file:line:column: expecting what"
+void write_diagnostic(std::ostream& os, std::string_view name, vb6_diagnostic const& d)
+{
+  os << name << ':' << d.where.line << ':' << d.where.column << ": expecting " << d.which << '\n';
+}
+
+void report_parse(batch_item& item, parse_result const& result)
+{
+  auto& res = item.res;
+  res.status = result.status;
+
+  std::ostringstream errors;
+  for(auto& d : result.diagnostics)
+    write_diagnostic(errors, res.name, d);
+  if(result.status != parse_status::ok && result.diagnostics.empty())
+  {
+    auto const where = line_index(item.unit).position(result.consumed);
+    errors << res.name << ':' << where.line << ':' << where.column << ": " << status_name(result.status) << '\n';
+  }
+  res.errors = errors.str();
+
+  // the AST owns copies of what it needs
+  item.unit = {};
+  std::string().swap(item.storage);
+}
+
+void parse_stage(batch_item& item, parse_session& session, perf_counters* counters)
+{
+  auto& res = item.res;
+  if(!res.loaded)
+    return;
+  VB6_PROBE(file__start, res.name.c_str(), res.bytes);
+
+  std::optional<perf_scope> perf;
+  if(counters)
+    perf.emplace(*counters, res.perf.parse);
+  auto const start = trace_clock();
+  auto const& result = session.parse_unit(item.unit, item.layout, item.ast);
+  res.parse_ns = elapsed_ns(start);
+  report_parse(item, result);
+}
+
+// Cuts a big file at procedure boundaries, false if it is better parsed whole.
+bool split_stage(batch_item& item, std::size_t piece_bytes)
+{
+  auto& res = item.res;
+  auto const code_begin = item.layout.code_begin;
+  if(!res.loaded || piece_bytes == 0 || item.unit.size() - code_begin < 2 * piece_bytes)
+    return false;
+
+  auto const start = trace_clock();
+  auto cuts = split_module(item.unit.substr(code_begin), piece_bytes);
+  for(auto& cut : cuts)
+    cut += code_begin;
+  res.parse_ns = elapsed_ns(start);
+  if(cuts.size() < 2)
+    return false;
+  VB6_PROBE(file__start, res.name.c_str(), res.bytes);
+
+  auto const pieces = cuts.size();
+  cuts.push_back(item.unit.size());
+  item.split = std::make_unique<split_parse>();
+  item.split->cuts = std::move(cuts);
+  item.split->asts.resize(pieces);
+  item.split->results.resize(pieces);
+  item.split->ns.resize(pieces);
+  item.split->perf.resize(pieces);
+  item.split->remaining = pieces;
+  return true;
+}
+
+// true for the piece that completes the file
+bool parse_piece(piece_task const& task, parse_session& session, perf_counters* counters)
+{
+  auto& item = *task.item;
+  auto& split = *item.split;
+  auto const i = task.piece;
+  {
+    trace_scope trace("piece", "parse", item.res.name);
+    std::optional<perf_scope> perf;
+    if(counters)
+      perf.emplace(*counters, split.perf[i]);
+    auto const start = trace_clock();
+    auto const text = item.unit.substr(split.cuts[i], split.cuts[i + 1] - split.cuts[i]);
+    split.results[i] = session.parse_module(text, split.asts[i]);
+    split.ns[i] = elapsed_ns(start);
+  }
+  return split.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1;
+}
+
+// The module is the items of the pieces in order, up to the first piece
+// that did not parse: parsing the whole file would have stopped there.
+void merge_pieces(batch_item& item)
+{
+  auto& res = item.res;
+  auto& split = *item.split;
+
+  parse_result result;
+  for(std::size_t i = 0; i < split.asts.size(); ++i)
+  {
+    res.parse_ns += split.ns[i];
+    res.perf.parse += split.perf[i];
+
+    auto& ast = split.asts[i];
+    item.ast.insert(item.ast.end(), std::make_move_iterator(ast.begin()), std::make_move_iterator(ast.end()));
+
+    auto& r = split.results[i];
+    for(auto& d : r.diagnostics)
+    {
+      d.offset += split.cuts[i];
+      result.diagnostics.push_back(std::move(d));
+    }
+    result.consumed = split.cuts[i] + r.consumed;
+    if(r.status != parse_status::ok)
+    {
+      result.status = r.status;
+      break;
+    }
+  }
+  if(!result.diagnostics.empty())
+    locate(result.diagnostics, line_index(item.unit));
+  item.split.reset();
+
+  report_parse(item, result);
+}
+
+void print_stage(batch_item& item, batch_options const& options, perf_counters* counters)
+{
+  auto& res = item.res;
+  if(res.status == parse_status::ok && options.format != output_format::none)
+  {
+    trace_scope print("print", "print", res.name);
+    std::optional<perf_scope> perf;
+    if(counters)
+      perf.emplace(*counters, res.perf.print);
+    auto const start = trace_clock();
+    std::ostringstream out;
+    print_ast(out, options.format, item.ast);
+    res.output = std::move(out).str();
+    res.print_ns = elapsed_ns(start);
+  }
+  item.ast = {};
+
+  if(res.loaded)
+    VB6_PROBE(file__done, res.name.c_str(), res.bytes, res.latency_ns(), static_cast<int>(!res.failed()));
+}
+
+// A 64 bit hash of the size and 8 bytes at a time of the contents, mixed
+// as in MurmurHash3 and xxHash. Not meant to resist crafted collisions, the
+// files hashing the same get their bytes compared.
+std::uint64_t content_hash(std::string_view s)
+{
+  constexpr std::uint64_t k1 = 0x9E3779B97F4A7C15ull;
+  constexpr std::uint64_t k2 = 0xC2B2AE3D27D4EB4Full;
+
+  auto mix = [](std::uint64_t h, std::uint64_t w) { return std::rotl(h ^ (w * k2), 31) * k1; };
+
+  auto h = static_cast<std::uint64_t>(s.size()) * k1;
+  std::size_t i = 0;
+  for(; i + 8 <= s.size(); i += 8)
+  {
+    std::uint64_t w;
+    std::memcpy(&w, s.data() + i, 8);
+    h = mix(h, w);
+  }
+  if(i < s.size())
+  {
+    std::uint64_t w = 0;
+    std::memcpy(&w, s.data() + i, s.size() - i);
+    h = mix(h, w);
+  }
+
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDull;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+// the lines of the diagnostics of a file start with its name
+std::string rename_diagnostics(std::string_view errors, std::string_view from, std::string_view to)
+{
+  std::string renamed;
+  while(!errors.empty())
+  {
+    auto const eol = errors.find('\n');
+    auto const line = errors.substr(0, eol == std::string_view::npos ? errors.size() : eol + 1);
+    errors.remove_prefix(line.size());
+    if(line.starts_with(from))
+      renamed.append(to).append(line.substr(from.size()));
+    else
+      renamed.append(line);
+  }
+  return renamed;
+}
+
+// What a file whose contents were seen before takes from the file parsed instead.
+struct shared_results
+{
+  std::string name;
+  parse_status status;
+  std::string output;
+  std::string errors;
+  std::uint64_t ns;
+};
+
+// The contents loaded by a pipeline, shared by the loader that tells the
+// duplicates and the printing that passes them the results. The results of
+// a file are only kept if a duplicate of it has been loaded by the time it
+// is printed; a duplicate loaded later is parsed again, and its results are
+// the ones kept if one more copy comes.
+class content_table
+{
+public:
+  explicit content_table(std::uint64_t (*hash)(std::string_view))
+    : hash(hash ? hash : content_hash)
+  {
+  }
+
+  // Sets content to what tells the contents of unit from the others, the
+  // index of the first file having them: the hash only finds the candidates,
+  // whose bytes are compared. The bytes are copied unless stable (in the
+  // mapping of an archive). False if the contents were loaded before and
+  // the file is to wait for the results of the one that got parsed.
+  bool claim(std::string_view unit, bool stable, std::size_t index, std::size_t& content)
+  {
+    auto const h = hash(unit);
+    std::lock_guard const lock(mutex);
+
+    entry* e = nullptr;
+    auto const [first, last] = by_hash.equal_range(h);
+    for(auto it = first; it != last && !e; ++it)
+    {
+      auto& candidate = entries.at(it->second);
+      if(candidate.bytes.size() == unit.size() && std::memcmp(candidate.bytes.data(), unit.data(), unit.size()) == 0)
+      {
+        content = it->second;
+        e = &candidate;
+      }
+    }
+    if(!e)
+    {
+      content = index;
+      by_hash.emplace(h, index);
+      e = &entries[index];
+      if(stable)
+        e->bytes = unit;
+      else
+      {
+        e->copy.assign(unit);
+        e->bytes = e->copy;
+      }
+    }
+    else if(!e->printed || e->results)
+    {
+      e->wanted = true;
+      return false;
+    }
+    e->original = index;
+    e->printed = false;
+    return true;
+  }
+
+  // the file that got parsed for contents has been printed
+  void printed(std::size_t content, file_result const& res)
+  {
+    std::lock_guard const lock(mutex);
+    auto& e = entries.at(content);
+    e.printed = true;
+    if(e.wanted && !e.results)
+      e.results = std::make_shared<shared_results const>(
+        shared_results{ res.name, res.status, res.output, res.errors, res.parse_ns + res.print_ns });
+  }
+
+  // null until the file that got parsed for contents is printed
+  std::shared_ptr<shared_results const> results(std::size_t content) const
+  {
+    std::lock_guard const lock(mutex);
+    return entries.at(content).results;
+  }
+
+private:
+  struct entry
+  {
+    std::size_t original = 0;
+    bool printed = false;
+    bool wanted = false; // by a duplicate
+    std::shared_ptr<shared_results const> results;
+    std::string copy;       // of the contents, unless stable
+    std::string_view bytes; // the contents
+  };
+
+  std::uint64_t (*hash)(std::string_view);
+  mutable std::mutex mutex;
+  std::unordered_map<std::size_t, entry> entries;     // by content
+  std::unordered_multimap<std::uint64_t, std::size_t> by_hash;
+};
+
+void reuse_results(batch_item& item, shared_results const& shared)
+{
+  auto& res = item.res;
+  res.status = shared.status;
+  res.output = shared.output;
+  res.errors = rename_diagnostics(shared.errors, shared.name, res.name);
+  res.duplicate_of = shared.name;
+  res.reused_ns = shared.ns;
+  item.ast = {};
+}
+
+void signal_work(std::atomic<std::uint32_t>& work)
+{
+  work.fetch_add(1, std::memory_order_release);
+  work.notify_all();
+}
+
+// what the loader of a pipeline sees of it
+struct load_target
+{
+  bounded_queue<std::unique_ptr<batch_item>>& loaded;
+  std::atomic<std::size_t> const& emitted;
+  std::size_t window;
+  std::size_t count;
+  content_table* contents; // null when not deduplicating
+  std::atomic<std::uint32_t>& work; // wakes the idle parsing threads
+
+  // passes a file to the parsing threads, the loaded ones hashed first
+  void push(std::unique_ptr<batch_item>& item) const
+  {
+    if(item->res.loaded)
+      sniff_stage(*item);
+    if(contents && item->res.loaded)
+    {
+      // a unit not read in storage lives in the mapping of an archive
+      bool const stable = item->storage.empty() && !item->unit.empty();
+      item->duplicate = !contents->claim(item->unit, stable, item->index, item->content);
+      if(item->duplicate)
+      {
+        item->unit = {};
+        std::string().swap(item->storage);
+      }
+    }
+    loaded.push(item);
+    signal_work(work);
+  }
+
+  // Files are handed to the sink in order, so one slow file holds back the
+  // others: the loader waits for it when too far ahead, instead of filling
+  // the memory with files that cannot be given out yet.
+  std::size_t limit() const { return std::min(count, emitted.load(std::memory_order_acquire) + window); }
+
+  void wait_for_room(std::size_t next) const
+  {
+    for(auto e = emitted.load(std::memory_order_acquire); next >= e + window; e = emitted.load(std::memory_order_acquire))
+      emitted.wait(e, std::memory_order_acquire);
+  }
+};
+
+// load gets run on its own thread and has to push the count files to the
+// loaded queue, in any order
+template <typename Load>
+batch_report run_pipeline(std::size_t count, batch_options const& options, batch_sink const& sink, Load load)
+{
+  batch_report report;
+  report.files.resize(count);
+
+  auto const start = trace_clock();
+
+  auto const jobs = std::max(1u, std::min<unsigned>(options.jobs, static_cast<unsigned>(count)));
+  auto const depth = options.queue_depth ? options.queue_depth : 2 * std::size_t(jobs);
+  bounded_queue<std::unique_ptr<batch_item>> loaded(depth);
+  bounded_queue<std::unique_ptr<batch_item>> parsed(depth);
+
+  std::optional<content_table> contents;
+  if(options.deduplicate)
+    contents.emplace(options.content_hash);
+
+  std::atomic<std::size_t> emitted = 0;
+  // bumped whenever an idle parsing thread may find something to do, or
+  // may find that the work is over
+  std::atomic<std::uint32_t> work = 0;
+
+  load_target const target{ loaded, emitted, loaded.capacity() + parsed.capacity() + jobs, count,
+                            contents ? &*contents : nullptr, work };
+
+  std::thread loader([&] {
+    load(target);
+    loaded.close();
+    signal_work(work);
+  });
+
+  // Files are taken from the loader one at a time, the big ones cut into
+  // pieces that the other parsing threads steal when they have nothing
+  // else to do, so that a huge file does not keep one thread busy while the
+  // others wait at the end of the run.
+  work_stealing_deques<piece_task> pieces(jobs);
+  std::atomic<std::size_t> splitting = 0;
+  std::atomic<unsigned> parsing = jobs;
+
+  auto parser = [&](std::size_t self) {
+    std::optional<perf_counters> storage;
+    auto const counters = open_counters(options, storage);
+    parse_session session;
+
+    for(unsigned spins = 0;; ++spins)
+    {
+      // read before looking for work, whatever comes after it changes the count
+      auto const seen = work.load(std::memory_order_acquire);
+
+      piece_task task;
+      if(pieces.pop(self, task) || pieces.steal(self, task))
+      {
+        signal_work(work); // the last piece may be gone
+        if(parse_piece(task, session, counters))
+        {
+          std::unique_ptr<batch_item> item(task.item);
+          merge_pieces(*item);
+          parsed.push(item);
+        }
+        spins = 0;
+        continue;
+      }
+
+      // while a file is being cut the others must not think the work is over
+      auto const closed = loaded.closed();
+      splitting.fetch_add(1, std::memory_order_seq_cst);
+      std::unique_ptr<batch_item> item;
+      if(loaded.try_pop(item))
+      {
+        if(item->duplicate)
+          parsed.push(item);
+        else if(split_stage(*item, options.piece_bytes))
+        {
+          auto const raw = item.release();
+          for(std::size_t i = 0; i < raw->split->asts.size(); ++i)
+            pieces.push(self, { raw, i });
+        }
+        else
+        {
+          parse_stage(*item, session, counters);
+          parsed.push(item);
+        }
+        splitting.fetch_sub(1, std::memory_order_seq_cst);
+        signal_work(work);
+        spins = 0;
+        continue;
+      }
+      splitting.fetch_sub(1, std::memory_order_seq_cst);
+
+      if(closed && splitting.load(std::memory_order_seq_cst) == 0 && pieces.size() == 0)
+        break;
+      // a short spin, then sleep until a file, a piece or the end comes
+      if(spins >= 64)
+        work.wait(seen, std::memory_order_acquire);
+      else if(spins >= 16)
+        std::this_thread::yield();
+    }
+
+    if(parsing.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      parsed.close();
+  };
+
+  std::vector<std::thread> parsers;
+  for(unsigned j = 0; j < jobs; ++j)
+    parsers.emplace_back(parser, j);
+
+  // printing, then handing out whatever is next in order
+  {
+    std::optional<perf_counters> storage;
+    auto const counters = open_counters(options, storage);
+    std::vector<char> done(count);
+    std::size_t next = 0;
+    // duplicates whose contents are still being parsed, by content
+    std::unordered_multimap<std::size_t, std::unique_ptr<batch_item>> waiting;
+
+    auto finish = [&](std::unique_ptr<batch_item>& item) {
+      done[item->index] = true;
+      report.files[item->index] = std::move(item->res);
+      item.reset();
+    };
+
+    for(std::unique_ptr<batch_item> item; parsed.pop(item);)
+    {
+      if(item->duplicate)
+      {
+        auto const shared = contents->results(item->content);
+        if(!shared)
+        {
+          auto const content = item->content;
+          waiting.emplace(content, std::move(item));
+          continue;
+        }
+        reuse_results(*item, *shared);
+        finish(item);
+      }
+      else
+      {
+        print_stage(*item, options, counters);
+        if(contents && item->res.loaded)
+        {
+          auto const content = item->content;
+          contents->printed(content, item->res);
+          finish(item);
+
+          auto const [first, last] = waiting.equal_range(content);
+          if(first != last)
+          {
+            auto const shared = contents->results(content);
+            for(auto it = first; it != last; ++it)
+            {
+              reuse_results(*it->second, *shared);
+              finish(it->second);
+            }
+            waiting.erase(first, last);
+          }
+        }
+        else
+          finish(item);
+      }
+
+      for(; next < count && done[next]; ++next)
+      {
+        if(sink)
+        {
+          auto& res = report.files[next];
+          sink(res);
+          std::string().swap(res.output);
+          std::string().swap(res.errors);
+        }
+      }
+      emitted.store(next, std::memory_order_release);
+      emitted.notify_one();
+    }
+  }
+
+  loader.join();
+  for(auto& t : parsers)
+    t.join();
+
+  report.wall_ns = elapsed_ns(start);
+  return report;
+}
+
+double mb_per_second(std::size_t bytes, std::uint64_t ns)
+{
+  return ns ? static_cast<double>(bytes) * 1e3 / static_cast<double>(ns) : 0.0;
+}
+
+}
+
+std::optional<output_format> parse_output_format(std::string_view name)
+{
+  if(name == "none")
+    return output_format::none;
+  if(name == "vb")
+    return output_format::vb;
+  if(name == "cpp")
+    return output_format::cpp;
+  if(name == "raw")
+    return output_format::raw;
+  if(name == "json")
+    return output_format::json;
+  if(name == "binary")
+    return output_format::binary;
+  return {};
+}
+
+std::vector<fs::path> collect_inputs(std::vector<std::string> const& args, std::ostream& err)
+{
+  std::vector<fs::path> inputs;
+  std::set<fs::path> seen;
+  auto add = [&](fs::path const& p) {
+    if(seen.insert(p.lexically_normal()).second)
+      inputs.push_back(p);
+  };
+
+  for(auto& arg : args)
+  {
+    fs::path const p(arg);
+    auto const name = p.filename().string();
+    std::error_code ec;
+
+    if(name.find_first_of("*?") != std::string::npos)
+    {
+      auto const dir = p.has_parent_path() ? p.parent_path() : fs::path(".");
+      std::vector<fs::path> matches;
+      for(auto& entry : fs::directory_iterator(dir, ec))
+      {
+        if(entry.is_regular_file() && wildcard_match(name, entry.path().filename().string()))
+          matches.push_back(p.has_parent_path() ? entry.path() : entry.path().filename());
+      }
+      if(matches.empty())
+        err << "No file matches: " << arg << '\n';
+      std::sort(matches.begin(), matches.end());
+      for(auto& m : matches)
+        add(m);
+    }
+    else if(fs::is_directory(p, ec))
+    {
+      std::vector<fs::path> files;
+      for(auto& entry : fs::recursive_directory_iterator(p, ec))
+      {
+        if(entry.is_regular_file() && is_source_file(entry.path()))
+          files.push_back(entry.path());
+      }
+      std::sort(files.begin(), files.end());
+      for(auto& f : files)
+        add(f);
+    }
+    else if(iequals(p.extension().string(), ".vbp"))
+    {
+      for(auto& unit : project_units(p, err))
+        add(unit);
+    }
+    else if(fs::exists(p, ec))
+      add(p);
+    else
+      err << "No such file: " << arg << '\n';
+  }
+  return inputs;
+}
+
+std::size_t batch_report::failures() const
+{
+  return static_cast<std::size_t>(std::count_if(files.begin(), files.end(), [](auto& f) { return f.failed(); }));
+}
+
+std::size_t batch_report::bytes() const
+{
+  std::size_t total = 0;
+  for(auto& f : files)
+    total += f.bytes;
+  return total;
+}
+
+std::size_t batch_report::duplicates() const
+{
+  return static_cast<std::size_t>(std::count_if(files.begin(), files.end(), [](auto& f) { return !f.duplicate_of.empty(); }));
+}
+
+std::size_t batch_report::duplicate_bytes() const
+{
+  std::size_t total = 0;
+  for(auto& f : files)
+  {
+    if(!f.duplicate_of.empty())
+      total += f.bytes;
+  }
+  return total;
+}
+
+std::uint64_t batch_report::latency_percentile(double p) const
+{
+  if(files.empty())
+    return 0;
+  std::vector<std::uint64_t> latencies;
+  latencies.reserve(files.size());
+  for(auto& f : files)
+    latencies.push_back(f.latency_ns());
+  std::sort(latencies.begin(), latencies.end());
+
+  // nearest rank
+  auto rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(latencies.size())));
+  rank = std::clamp<std::size_t>(rank, 1, latencies.size());
+  return latencies[rank - 1];
+}
+
+file_result process_file(fs::path const& file, batch_options const& options, perf_counters* counters)
+{
+  batch_item item;
+  load_stage(file, item, counters);
+  parse_session session;
+  parse_stage(item, session, counters);
+  print_stage(item, options, counters);
+  return std::move(item.res);
+}
+
+file_result process_stream(std::istream& in, std::string name, batch_options const& options, std::ostream& out)
+{
+  file_result res;
+  res.name = std::move(name);
+  res.loaded = true;
+  VB6_PROBE(file__start, res.name.c_str(), std::size_t{ 0 });
+
+  // reading the stream is part of the parse, the printing is timed apart
+  auto const start = trace_clock();
+  auto const result = parse_module_stream(in, [&](vb6_ast::vb_module& items) {
+    auto const print_start = trace_clock();
+    print_ast(out, options.format, items);
+    res.print_ns += elapsed_ns(print_start);
+  });
+  res.parse_ns = elapsed_ns(start) - res.print_ns;
+  res.bytes = result.consumed;
+  res.kind = result.kind;
+  res.status = result.status;
+
+  std::ostringstream errors;
+  for(auto& d : result.diagnostics)
+    write_diagnostic(errors, res.name, d);
+  if(result.status != parse_status::ok && result.diagnostics.empty())
+    errors << res.name << ": " << status_name(result.status) << " at byte " << result.consumed << '\n';
+  res.errors = errors.str();
+
+  VB6_PROBE(file__done, res.name.c_str(), res.bytes, res.latency_ns(), static_cast<int>(!res.failed()));
+  return res;
+}
+
+batch_report run_batch(std::vector<fs::path> const& files, batch_options const& options, batch_sink const& sink)
+{
+  // Keeps up to options.read_ahead files being read, in the limits of the
+  // window, and passes them on in the order they come.
+  auto reader = make_file_reader(options.read_ahead, options.use_io_uring);
+
+  auto report = run_pipeline(files.size(), options, sink, [&](load_target const& target) {
+    auto const read_ahead = std::max<std::size_t>(options.read_ahead, 1);
+    std::size_t next = 0;
+    for(;;)
+    {
+      for(auto const limit = target.limit(); next < limit && reader->in_flight() < read_ahead; ++next)
+        reader->submit(next, files[next]);
+
+      read_result read;
+      if(!reader->wait(read))
+      {
+        if(next == files.size())
+          break;
+        // all that is read waits for the file to be handed out next
+        target.wait_for_room(next);
+        continue;
+      }
+
+      auto item = std::make_unique<batch_item>();
+      item->index = read.index;
+      auto& res = item->res;
+      res.name = files[read.index].string();
+      res.perf.name = res.name;
+      res.loaded = read.ok;
+      res.load_ns = read.end - read.start;
+      if(trace_enabled())
+        trace_event("load", "io", read.start, read.end, res.name);
+      if(res.loaded)
+      {
+        item->storage = std::move(read.contents);
+        item->unit = item->storage;
+        res.bytes = item->unit.size();
+      }
+      else
+        res.errors = res.name + ": could not be read\n";
+      target.push(item);
+    }
+  });
+  report.reader = reader->name();
+  return report;
+}
+
+batch_report run_batch(archive_view const& archive, batch_options const& options, batch_sink const& sink)
+{
+  auto report = run_pipeline(archive.size(), options, sink, [&](load_target const& target) {
+    for(std::size_t i = 0; i < archive.size(); ++i)
+    {
+      target.wait_for_room(i);
+
+      auto item = std::make_unique<batch_item>();
+      item->index = i;
+      auto& res = item->res;
+      res.name = archive[i].name;
+      res.perf.name = res.name;
+      res.loaded = true;
+      item->unit = archive[i].contents;
+      res.bytes = item->unit.size();
+      target.push(item);
+    }
+  });
+  report.reader = "archive";
+  return report;
+}
+
+void print_batch_stats(std::ostream& os, batch_report const& report)
+{
+  os << std::left << std::setw(40) << "file" << std::right
+     << std::setw(12) << "bytes" << std::setw(12) << "ms" << std::setw(10) << "MB/s" << "  status\n";
+  for(auto& f : report.files)
+  {
+    os << std::left << std::setw(40) << f.name << std::right
+       << std::setw(12) << f.bytes
+       << std::setw(12) << std::fixed << std::setprecision(3) << static_cast<double>(f.latency_ns()) / 1e6
+       << std::setw(10) << std::setprecision(2) << mb_per_second(f.bytes, f.latency_ns())
+       << "  " << (!f.quarantined.empty() ? "quarantined" : f.loaded ? status_name(f.status) : "unreadable") << '\n';
+  }
+
+  std::uint64_t reused = 0;
+  for(auto& f : report.files)
+    reused += f.reused_ns;
+
+  os << '\n'
+     << "files        " << report.files.size() << '\n'
+     << "failures     " << report.failures() << '\n'
+     << "bytes        " << report.bytes() << '\n'
+     << "wall time    " << std::setprecision(3) << static_cast<double>(report.wall_ns) / 1e6 << " ms\n"
+     << "reader       " << report.reader << '\n'
+     << "duplicates   " << report.duplicates() << " files, " << report.duplicate_bytes() << " bytes not parsed, "
+     << std::setprecision(3) << static_cast<double>(reused) / 1e6 << " ms saved\n"
+     << "throughput   " << std::setprecision(2) << mb_per_second(report.bytes(), report.wall_ns) << " MB/s\n"
+     << "latency p50  " << std::setprecision(3) << static_cast<double>(report.latency_percentile(50)) / 1e6 << " ms\n"
+     << "latency p99  " << static_cast<double>(report.latency_percentile(99)) / 1e6 << " ms\n";
+}
+
+}
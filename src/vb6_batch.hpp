@@ -0,0 +1,132 @@
+//: vb6_batch.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include "vb6_archive.hpp"
+#include "vb6_parse_budget.hpp"
+#include "vb6_perf_counters.hpp"
+#include "vb6_unit.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vb6_grammar {
+
+  enum class output_format
+  {
+    none,
+    vb,     // vb6_ast_printer
+    cpp,    // cpp_ast_printer
+    raw,    // raw_ast_printer
+    json,   // write_ast_json
+    binary  // write_ast_binary
+  };
+
+  std::optional<output_format> parse_output_format(std::string_view name);
+
+  // The source files named by the arguments, in order and without repetitions:
+  // files as they are, directories searched recursively for .bas, .cls, .frm
+  // and .ctl files, '*' and '?' wildcards in the last component of a path and
+  // the units listed in .vbp projects. What cannot be found is reported to err.
+  std::vector<std::filesystem::path> collect_inputs(std::vector<std::string> const& args, std::ostream& err);
+
+  struct batch_options
+  {
+    unsigned jobs = 1;
+    output_format format = output_format::none;
+    bool perf_counters = false; // sample the hardware counters of every phase
+    std::size_t queue_depth = 0; // files waiting between two stages, 0 for twice the jobs
+    std::size_t read_ahead = 32;  // files being read at once
+    bool use_io_uring = true;     // else a pool of threads reads them
+    std::size_t piece_bytes = 256 * 1024; // files of twice this size or more get parsed in pieces, 0 never
+    bool deduplicate = true; // files with the same contents as an earlier one reuse its results
+    // picks the files that may have the same contents, whose bytes then get
+    // compared; a fast 64 bit hash when null (the tests force collisions)
+    std::uint64_t (*content_hash)(std::string_view) = nullptr;
+  };
+
+  struct file_result
+  {
+    std::string name;
+    bool loaded = false;
+    unit_kind kind = unit_kind::module; // see sniff_unit
+    std::size_t bytes = 0;
+    parse_status status = parse_status::syntax_error;
+    std::uint64_t load_ns = 0;
+    std::uint64_t parse_ns = 0;
+    std::uint64_t print_ns = 0;
+    std::string output; // in the requested format
+    std::string errors; // diagnostics, one per line
+    perf_file_report perf;
+    std::string quarantined; // why the supervisor set the file aside, see vb6_supervisor.hpp
+    std::string duplicate_of; // the file with the same contents that got parsed instead
+    std::uint64_t reused_ns = 0; // parsing and printing of that file, not done again for this one
+
+    bool failed() const { return !loaded || status != parse_status::ok || !quarantined.empty(); }
+    std::uint64_t latency_ns() const { return load_ns + parse_ns + print_ns; }
+  };
+
+  struct batch_report
+  {
+    std::vector<file_result> files; // in the order of the inputs
+    std::uint64_t wall_ns = 0;
+    std::string reader; // what read the files, see make_file_reader
+
+    std::size_t failures() const;
+    std::size_t bytes() const;
+    std::size_t duplicates() const;
+    std::size_t duplicate_bytes() const;
+
+    // of the per-file latencies, p in [0, 100]
+    std::uint64_t latency_percentile(double p) const;
+  };
+
+  // Loads, parses and prints one file on the calling thread.
+  // counters, when not null, get sampled for every phase.
+  file_result process_file(std::filesystem::path const& file, batch_options const& options, perf_counters* counters = nullptr);
+
+  // Parses and prints a unit coming from a stream (stdin, a pipe) as it gets
+  // read, holding only the part not parsed yet (see parse_module_stream). The
+  // output goes to out as the items get parsed, instead of into the result.
+  file_result process_stream(std::istream& in, std::string name, batch_options const& options, std::ostream& out);
+
+  // called with every file in the order of the inputs, as soon as it is done
+  using batch_sink = std::function<void(file_result const&)>;
+
+  // Loads, parses and prints the files in a pipeline: a loader thread keeping
+  // options.read_ahead reads in flight (see vb6_file_reader.hpp), then
+  // options.jobs parsing threads, then the printing on the calling thread,
+  // connected by queues of options.queue_depth files. Big files are cut at
+  // procedure boundaries (see split_module) into pieces that any parsing
+  // thread can take. No more than a bounded number of files are loaded and
+  // not yet handed to the sink, so the memory does not grow with the number
+  // of files.
+  // With options.deduplicate the contents of every file get hashed when
+  // loaded, and a file with the same contents as one already seen is not
+  // parsed: it gets the status, output and diagnostics of the other one,
+  // once their bytes have been compared. A copy of the contents of every
+  // file parsed is kept for that until the end, except for the entries of an
+  // archive, compared where they are in the mapping. The results of the
+  // contents found more than once are kept until the end too.
+  // With a sink, the output and errors of the files are given to it and left
+  // out of the report. The hardware counters are not sampled for the loading.
+  batch_report run_batch(std::vector<std::filesystem::path> const& files, batch_options const& options, batch_sink const& sink = {});
+
+  // same as above, the units being the entries of the archive, parsed where
+  // they are in the mapping
+  batch_report run_batch(archive_view const& archive, batch_options const& options, batch_sink const& sink = {});
+
+  // per-file and aggregate throughput, p50/p99 latency and failure count
+  void print_batch_stats(std::ostream& os, batch_report const& report);
+}
@@ -0,0 +1,167 @@
+//: vb6_bounded_queue.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace vb6_grammar {
+
+  // Fixed capacity multi-producer multi-consumer queue without locks, every
+  // slot has a sequence number telling whose turn it is (D. Vyukov's design).
+  // push() waits while the queue is full, which is what keeps a fast stage
+  // from running away from a slow one. The waits spin for a short while and
+  // then block on a count of the pushes or pops (atomic wait), so that a
+  // stage waiting on the disk or on a slow printer does not hold a core.
+  template <typename T>
+  class bounded_queue
+  {
+  public:
+    // the capacity is rounded up to a power of two
+    explicit bounded_queue(std::size_t capacity)
+    {
+      std::size_t size = 2;
+      while(size < capacity)
+        size *= 2;
+      mask = size - 1;
+      cells = std::make_unique<cell[]>(size);
+      for(std::size_t i = 0; i < size; ++i)
+        cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    bounded_queue(bounded_queue const&) = delete;
+    bounded_queue& operator=(bounded_queue const&) = delete;
+
+    std::size_t capacity() const { return mask + 1; }
+
+    // moves value in, false if the queue is full
+    bool try_push(T& value)
+    {
+      auto pos = tail.load(std::memory_order_relaxed);
+      for(;;)
+      {
+        auto& c = cells[pos & mask];
+        auto const seq = c.seq.load(std::memory_order_acquire);
+        auto const diff = static_cast<std::ptrdiff_t>(seq - pos);
+        if(diff == 0)
+        {
+          if(tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          {
+            c.value = std::move(value);
+            c.seq.store(pos + 1, std::memory_order_release);
+            signal(pushes);
+            return true;
+          }
+        }
+        else if(diff < 0)
+          return false;
+        else
+          pos = tail.load(std::memory_order_relaxed);
+      }
+    }
+
+    // moves the oldest element out, false if the queue is empty
+    bool try_pop(T& value)
+    {
+      auto pos = head.load(std::memory_order_relaxed);
+      for(;;)
+      {
+        auto& c = cells[pos & mask];
+        auto const seq = c.seq.load(std::memory_order_acquire);
+        auto const diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+        if(diff == 0)
+        {
+          if(head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          {
+            value = std::move(c.value);
+            c.seq.store(pos + mask + 1, std::memory_order_release);
+            signal(pops);
+            return true;
+          }
+        }
+        else if(diff < 0)
+          return false;
+        else
+          pos = head.load(std::memory_order_relaxed);
+      }
+    }
+
+    // waits for room, false (and value left alone) if the queue got closed
+    bool push(T& value)
+    {
+      for(unsigned spins = 0;; ++spins)
+      {
+        // read before trying, a pop coming after it changes the count
+        auto const seen = pops.load(std::memory_order_acquire);
+        if(is_closed.load(std::memory_order_acquire))
+          return false;
+        if(try_push(value))
+          return true;
+        backoff(pops, seen, spins);
+      }
+    }
+
+    // waits for an element, false once the queue is closed and drained
+    bool pop(T& value)
+    {
+      for(unsigned spins = 0;; ++spins)
+      {
+        auto const seen = pushes.load(std::memory_order_acquire);
+        if(try_pop(value))
+          return true;
+        if(is_closed.load(std::memory_order_acquire))
+          return try_pop(value);
+        backoff(pushes, seen, spins);
+      }
+    }
+
+    // no more pushes, consumers get what is left and then false
+    void close()
+    {
+      is_closed.store(true, std::memory_order_release);
+      signal(pushes);
+      signal(pops);
+    }
+
+    bool closed() const { return is_closed.load(std::memory_order_acquire); }
+
+  private:
+    struct cell
+    {
+      std::atomic<std::size_t> seq;
+      T value;
+    };
+
+    static void signal(std::atomic<std::uint32_t>& count)
+    {
+      count.fetch_add(1, std::memory_order_release);
+      count.notify_all(); // no system call without waiters
+    }
+
+    static void backoff(std::atomic<std::uint32_t> const& count, std::uint32_t seen, unsigned spins)
+    {
+      if(spins < 16)
+        return;
+      if(spins < 64)
+        std::this_thread::yield();
+      else
+        count.wait(seen, std::memory_order_acquire);
+    }
+
+    std::unique_ptr<cell[]> cells;
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> head = 0;
+    alignas(64) std::atomic<std::size_t> tail = 0;
+    alignas(64) std::atomic<bool> is_closed = false;
+    alignas(64) std::atomic<std::uint32_t> pushes = 0;
+    alignas(64) std::atomic<std::uint32_t> pops = 0;
+  };
+}
@@ -7,29 +7,81 @@
 #pragma once
 
 #include "vb6_error_handler.hpp"
+#include "vb6_parser_define.hpp"
 #include "vb6_parser.hpp" // only for having vb6_grammar::skip_type
+#include "vb6_piece_table.hpp"
 
 #include <boost/spirit/home/x3.hpp>
 
+#include <functional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace vb6_grammar {
 
 namespace x3 = boost::spirit::x3;
 
-using iterator_type = std::string_view::const_iterator;
+// The grammar gets instantiated for these iterators (see VB6_SPIRIT_INSTANTIATE),
+// the entry points of vb6_parser_api.hpp pick the one that fits their input.
+using iterator_type = std::string_view::const_iterator; // what the rules are usually given
 //using iterator_type = std::string::const_iterator;
+using pointer_iterator = char const*;                   // contiguous text, the fast path
+using rope_iterator = piece_iterator;                   // text in pieces, see piece_text
 
 using phrase_context_type = x3::phrase_parse_context<skip_type>::type;
 
 using error_handler_type = vb6_error_handler<iterator_type>;
 //using error_handler_type = x3::unused_type;
 
-using context_type = x3::context<vb6_error_handler_tag
-                               , std::reference_wrapper<error_handler_type>
-                               , phrase_context_type>;
+template <typename Iterator>
+using context_for = x3::context<vb6_error_handler_tag
+                              , std::reference_wrapper<vb6_error_handler<Iterator>>
+                              , phrase_context_type>;
 //using context_type = x3::context<x3::skipper_tag
 //                               , x3::char_class<boost::spirit::char_encoding::ascii, x3::blank_tag> const
 //                               , x3::unused_type>;
 
-}
\ No newline at end of file
+// context of check_syntax(), the rules get parsed without attributes
+template <typename Iterator>
+using recognizer_context_for = x3::context<vb6_error_handler_tag
+                                         , std::reference_wrapper<vb6_error_handler<Iterator>>
+                                         , x3::context<vb6_recognizer_tag
+                                                     , std::true_type
+                                                     , phrase_context_type>>;
+
+using context_type = context_for<iterator_type>;
+using recognizer_context_type = recognizer_context_for<iterator_type>;
+
+// With libstdc++ and libc++ std::string_view::const_iterator is already a
+// pointer, and the rules must not be instantiated twice for it.
+#if defined(_MSVC_STL_VERSION) || defined(_LIBCPP_ABI_USE_WRAP_ITER_IN_STD_STRING_VIEW) \
+ || defined(_LIBCPP_ABI_BOUNDED_ITERATORS_IN_STRING_VIEW)
+#define VB6_DISTINCT_POINTER_ITERATOR 1
+#else
+#define VB6_DISTINCT_POINTER_ITERATOR 0
+#endif
+
+static_assert(std::is_same_v<iterator_type, pointer_iterator> != bool(VB6_DISTINCT_POINTER_ITERATOR),
+              "VB6_DISTINCT_POINTER_ITERATOR does not match this standard library");
+
+}
+
+#define VB6_SPIRIT_INSTANTIATE_FOR(rule_type, Iterator)                                      \
+  BOOST_SPIRIT_INSTANTIATE(rule_type, Iterator, vb6_grammar::context_for<Iterator>)            \
+  BOOST_SPIRIT_INSTANTIATE(rule_type, Iterator, vb6_grammar::recognizer_context_for<Iterator>) \
+  /***/
+
+#if VB6_DISTINCT_POINTER_ITERATOR
+#define VB6_SPIRIT_INSTANTIATE_POINTER(rule_type) VB6_SPIRIT_INSTANTIATE_FOR(rule_type, pointer_iterator)
+#else
+#define VB6_SPIRIT_INSTANTIATE_POINTER(rule_type)
+#endif
+
+// The rope only gets the AST-building context, check_syntax() works on
+// contiguous text.
+#define VB6_SPIRIT_INSTANTIATE(rule_type)                                                    \
+  VB6_SPIRIT_INSTANTIATE_FOR(rule_type, iterator_type)                                     \
+  VB6_SPIRIT_INSTANTIATE_POINTER(rule_type)                                                \
+  BOOST_SPIRIT_INSTANTIATE(rule_type, rope_iterator, vb6_grammar::context_for<rope_iterator>) \
+  /***/
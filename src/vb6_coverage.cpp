@@ -0,0 +1,128 @@
+//: vb6_coverage.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_coverage.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+
+namespace vb6_grammar {
+
+namespace {
+
+// the grammar objects get built during the static initialization of every
+// translation unit including the grammar definitions
+struct site_registry
+{
+  std::mutex mutex;
+  std::vector<coverage_site> sites;
+};
+
+site_registry& registry()
+{
+  static site_registry reg;
+  return reg;
+}
+
+}
+
+std::size_t register_coverage_site(char const* rule, char const* alternative)
+{
+  auto& reg = registry();
+  std::lock_guard lock(reg.mutex);
+
+  for(std::size_t i = 0; i < reg.sites.size(); ++i)
+  {
+    if(std::strcmp(reg.sites[i].rule, rule) == 0 && std::strcmp(reg.sites[i].alternative, alternative) == 0)
+      return i;
+  }
+  reg.sites.push_back({ rule, alternative });
+  return reg.sites.size() - 1;
+}
+
+std::size_t coverage_site_count()
+{
+  auto& reg = registry();
+  std::lock_guard lock(reg.mutex);
+  return reg.sites.size();
+}
+
+coverage_site coverage_site_at(std::size_t index)
+{
+  auto& reg = registry();
+  std::lock_guard lock(reg.mutex);
+  return reg.sites.at(index);
+}
+
+coverage_counters& coverage_counters::operator+=(coverage_counters const& rhs)
+{
+  if(sites.size() < rhs.sites.size())
+    sites.resize(rhs.sites.size());
+  for(std::size_t i = 0; i < rhs.sites.size(); ++i)
+  {
+    sites[i].tries += rhs.sites[i].tries;
+    sites[i].hits += rhs.sites[i].hits;
+  }
+  return *this;
+}
+
+void print_coverage_report(std::ostream& os, coverage_counters const& counters)
+{
+  struct line
+  {
+    char const* alternative;
+    coverage_counters::counts counts;
+  };
+  std::map<std::string_view, std::vector<line>> rules;
+
+  auto const count = coverage_site_count();
+  for(std::size_t i = 0; i < count; ++i)
+  {
+    auto const site = coverage_site_at(i);
+    rules[site.rule].push_back({ site.alternative, counters.at(i) });
+  }
+
+  // the busiest rules first
+  std::vector<std::pair<std::string_view, std::size_t>> order;
+  for(auto& [rule, lines] : rules)
+  {
+    std::size_t tries = 0;
+    for(auto& l : lines)
+      tries += l.counts.tries;
+    order.emplace_back(rule, tries);
+  }
+  std::stable_sort(begin(order), end(order), [](auto& a, auto& b) { return a.second > b.second; });
+
+  for(auto& [rule, tries] : order)
+  {
+    auto& lines = rules[rule];
+    std::stable_sort(begin(lines), end(lines), [](line const& a, line const& b) {
+      return a.counts.hits > b.counts.hits;
+    });
+
+    os << rule << " (" << tries << " tries)\n";
+    for(auto& l : lines)
+    {
+      os << "  " << std::left << std::setw(28) << l.alternative << std::right;
+      if(l.counts.tries == 0)
+      {
+        os << std::setw(12) << "never tried" << '\n';
+        continue;
+      }
+      auto const failed = l.counts.tries - l.counts.hits;
+      os << std::setw(10) << l.counts.hits << " hits"
+         << std::setw(10) << failed << " misses ("
+         << std::fixed << std::setprecision(1) << 100.0 * failed / l.counts.tries << "%)\n";
+    }
+  }
+}
+
+}
@@ -0,0 +1,128 @@
+//: vb6_coverage.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <cstddef>
+#include <iosfwd>
+#include <type_traits>
+#include <vector>
+
+namespace vb6_grammar {
+
+  namespace x3 = boost::spirit::x3;
+
+  // An alternative of a rule whose use gets counted, see cover() below.
+  // Sites are registered once per program and named after the rule.
+  struct coverage_site
+  {
+    char const* rule;
+    char const* alternative;
+  };
+
+  // index of the site, the same one for the same names
+  std::size_t register_coverage_site(char const* rule, char const* alternative);
+
+  std::size_t coverage_site_count();
+  coverage_site coverage_site_at(std::size_t index);
+
+  // How many times every site was tried and how many times it matched.
+  // Give it to the error handler to have it filled, it can be reused for
+  // all the files of a corpus.
+  class coverage_counters
+  {
+  public:
+    struct counts
+    {
+      std::size_t tries = 0;
+      std::size_t hits = 0;
+    };
+
+    void tried(std::size_t site)
+    {
+      if(site >= sites.size())
+        sites.resize(coverage_site_count());
+      ++sites[site].tries;
+    }
+
+    void hit(std::size_t site) { ++sites[site].hits; }
+
+    counts at(std::size_t site) const { return site < sites.size() ? sites[site] : counts{}; }
+
+    coverage_counters& operator+=(coverage_counters const& rhs);
+
+  private:
+    std::vector<counts> sites;
+  };
+
+  // Per rule, the alternatives ranked by the number of matches, with the
+  // share of the tries that failed. The sites never tried are listed as well.
+  void print_coverage_report(std::ostream& os, coverage_counters const& counters);
+
+  struct vb6_error_handler_tag;
+
+  // Pass-through directive counting the tries and the matches of its
+  // subject. It costs a null pointer test unless counters are set in the
+  // error handler.
+  template <typename Subject>
+  struct cover_directive : x3::unary_parser<Subject, cover_directive<Subject>>
+  {
+    using base_type = x3::unary_parser<Subject, cover_directive<Subject>>;
+    static bool const is_pass_through_unary = true;
+
+    cover_directive(Subject const& subject, std::size_t site)
+      : base_type(subject), site(site)
+    {
+    }
+
+    template <typename Iterator, typename Context, typename RContext, typename Attribute>
+    bool parse(Iterator& first, Iterator const& last, Context const& context, RContext& rcontext, Attribute& attr) const
+    {
+      coverage_counters* counters = nullptr;
+      auto& handler = x3::get<vb6_error_handler_tag>(context);
+      if constexpr(!std::is_same_v<std::decay_t<decltype(handler)>, x3::unused_type>)
+        counters = handler.get().coverage();
+
+      if(counters)
+        counters->tried(site);
+      if(!this->subject.parse(first, last, context, rcontext, attr))
+        return false;
+      if(counters)
+        counters->hit(site);
+      return true;
+    }
+
+    std::size_t site;
+  };
+
+  struct cover_gen
+  {
+    char const* rule;
+    char const* alternative;
+
+    // an alternative that is a rule is named after it
+    template <typename Subject>
+    cover_directive<typename x3::extension::as_parser<Subject>::value_type>
+    operator[](Subject const& subject) const
+    {
+      auto const& parser = x3::as_parser(subject);
+      char const* name = alternative;
+      if constexpr(requires { parser.name; })
+      {
+        if(!name)
+          name = parser.name;
+      }
+      return { parser, register_coverage_site(rule, name ? name : "?") };
+    }
+  };
+
+  inline cover_gen cover(char const* rule, char const* alternative = nullptr)
+  {
+    return { rule, alternative };
+  }
+}
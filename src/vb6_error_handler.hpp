@@ -6,9 +6,24 @@
 
 #pragma once
 
+#include "vb6_coverage.hpp"
+#include "vb6_line_index.hpp"
+#include "vb6_parse_budget.hpp"
+#include "vb6_span_table.hpp"
+
 #include <boost/spirit/home/x3.hpp>
 #include <boost/spirit/home/x3/support/utility/error_reporting.hpp>
 
+#include <cctype>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace vb6_grammar {
 
   namespace x3 = boost::spirit::x3;
@@ -17,9 +32,143 @@ namespace vb6_grammar {
   // annotation_base
   // error_handler_base
 
+  // how a failed expectation (the '>' operator in the grammar) is surfaced
+  enum class expectation_policy
+  {
+    throw_failure, // throw x3::expectation_failure, same as x3::expect
+    diagnose       // record a vb6_diagnostic and let the parser fail
+  };
+
+  // a failed expectation, recorded instead of thrown
+  struct vb6_diagnostic
+  {
+    std::size_t offset; // from the beginning of the parsed buffer
+    std::string which;  // what the parser was expecting, as labelled in the grammar
+    line_col where{};   // filled in by the parse entry points, zero if unknown
+  };
+
+  inline void locate(std::vector<vb6_diagnostic>& diags, line_index const& lines)
+  {
+    for(auto& d : diags)
+      d.where = lines.position(d.offset);
+  }
+
   // our error handler
   template <typename Iterator>
-  using vb6_error_handler = x3::error_handler<Iterator>;
+  class vb6_error_handler : public x3::error_handler<Iterator>
+  {
+  public:
+    vb6_error_handler(Iterator first, Iterator last, std::ostream& err_out,
+                      std::string file = "", int tabs = 4)
+      : x3::error_handler<Iterator>(first, last, err_out, file, tabs),
+        first(first), last(last), err_out(err_out), file(file), tabs(tabs)
+    {
+    }
+
+    using x3::error_handler<Iterator>::operator();
+
+    // Same report as x3::error_handler, except that the line of err_pos
+    // is looked up in lines() instead of being counted from the beginning.
+    void operator()(Iterator err_pos, std::string const& error_message) const
+    {
+      while(err_pos != last && std::isspace(static_cast<unsigned char>(*err_pos)))
+        ++err_pos;
+
+      auto const pos = lines().position(offset_of(err_pos));
+      if(file != "")
+        err_out << "In file " << file << ", ";
+      else
+        err_out << "In ";
+      err_out << "line " << pos.line << ':' << std::endl;
+      err_out << error_message << std::endl;
+
+      auto const line_start = std::next(first, static_cast<std::ptrdiff_t>(lines().line_start(pos.line)));
+      auto line_end = line_start;
+      while(line_end != last && *line_end != '\r' && *line_end != '\n')
+        ++line_end;
+      err_out << std::string(line_start, line_end) << std::endl;
+
+      for(auto it = line_start; it != err_pos; ++it)
+        err_out << (*it == '\t' ? std::string(static_cast<std::size_t>(tabs), '_') : std::string(1, '_'));
+      err_out << "^_" << std::endl;
+    }
+
+    // built on first use
+    line_index const& lines() const
+    {
+      if(!index)
+      {
+        if constexpr(std::contiguous_iterator<Iterator>)
+          index.emplace(std::string_view(std::to_address(first), static_cast<std::size_t>(std::distance(first, last))));
+        else
+          index.emplace(first, last);
+      }
+      return *index;
+    }
+
+    line_col position_of(Iterator it) const { return lines().position(offset_of(it)); }
+
+    expectation_policy policy() const { return expect_policy; }
+    void policy(expectation_policy p) { expect_policy = p; }
+
+    std::size_t offset_of(Iterator it) const
+    {
+      return static_cast<std::size_t>(std::distance(first, it));
+    }
+
+    // called by vb6_grammar::expect when its subject fails
+    void expectation_failed(Iterator where, std::string which)
+    {
+      diags.push_back({ offset_of(where), std::move(which) });
+    }
+
+    // The parse went past [first, last), the expectations that failed in there
+    // belonged to alternatives that were given up, so they are not errors.
+    void recovered(Iterator first, Iterator last)
+    {
+      auto const from = offset_of(first);
+      auto const to = offset_of(last);
+      std::erase_if(diags, [&](vb6_diagnostic const& d) { return d.offset >= from && d.offset < to; });
+    }
+
+    std::vector<vb6_diagnostic> const& diagnostics() const { return diags; }
+
+    // lends the capacity of storage to the diagnostics, swapped back when done
+    void swap_diagnostics(std::vector<vb6_diagnostic>& storage) { diags.swap(storage); }
+
+    // step/time budget and cancellation of the current parse
+    budget_tracker& budget() { return tracker; }
+    budget_tracker const& budget() const { return tracker; }
+
+    // where the rules deriving from annotate_span record their spans, if any
+    span_table* spans() const { return span_store; }
+    void spans(span_table* table) { span_store = table; }
+
+    // where the alternatives marked with cover() are counted, if anywhere
+    coverage_counters* coverage() const { return coverage_store; }
+    void coverage(coverage_counters* counters) { coverage_store = counters; }
+
+    // where a node tagged in spans() begins, zero if it has not been tagged
+    line_col position_of(x3::position_tagged const& node) const
+    {
+      if(!span_store || node.id_first < 0)
+        return {};
+      return lines().position(span_store->span_of(node).begin);
+    }
+
+  private:
+    Iterator first;
+    Iterator last;
+    std::ostream& err_out;
+    std::string file;
+    int tabs;
+    mutable std::optional<line_index> index;
+    expectation_policy expect_policy = expectation_policy::throw_failure;
+    std::vector<vb6_diagnostic> diags;
+    budget_tracker tracker;
+    span_table* span_store = nullptr;
+    coverage_counters* coverage_store = nullptr;
+  };
 
   // tag used to get our error handler from the context
   //using vb6_error_handler_tag = x3::error_handler_tag;
@@ -39,4 +188,4 @@ namespace vb6_grammar {
     }
   };
 #endif
-}
\ No newline at end of file
+}
@@ -0,0 +1,436 @@
+//: vb6_file_reader.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_file_reader.hpp"
+#include "vb6_trace.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define VB6_IO_URING
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace vb6_grammar {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// the portable one
+class thread_file_reader final : public file_reader
+{
+public:
+  explicit thread_file_reader(std::size_t threads)
+  {
+    for(std::size_t i = 0; i < threads; ++i)
+      workers.emplace_back([this] { run(); });
+  }
+
+  ~thread_file_reader() override
+  {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+    requests_cv.notify_all();
+    for(auto& t : workers)
+      t.join();
+  }
+
+  char const* name() const override { return "threads"; }
+
+  void submit(std::size_t index, fs::path const& file) override
+  {
+    {
+      std::lock_guard lock(mutex);
+      requests.push_back({ index, file, trace_clock() });
+    }
+    ++pending;
+    requests_cv.notify_one();
+  }
+
+  bool wait(read_result& res) override
+  {
+    if(pending == 0)
+      return false;
+    std::unique_lock lock(mutex);
+    completed_cv.wait(lock, [this] { return !completed.empty(); });
+    res = std::move(completed.front());
+    completed.pop_front();
+    --pending;
+    return true;
+  }
+
+private:
+  struct request
+  {
+    std::size_t index;
+    fs::path file;
+    std::uint64_t start;
+  };
+
+  void run()
+  {
+    std::unique_lock lock(mutex);
+    for(;;)
+    {
+      requests_cv.wait(lock, [this] { return stopping || !requests.empty(); });
+      if(requests.empty())
+        return;
+      auto req = std::move(requests.front());
+      requests.pop_front();
+      lock.unlock();
+
+      read_result res;
+      res.index = req.index;
+      res.start = req.start;
+      res.ok = read_file(req.file, res.contents);
+      res.end = trace_clock();
+
+      lock.lock();
+      completed.push_back(std::move(res));
+      completed_cv.notify_one();
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable requests_cv;
+  std::condition_variable completed_cv;
+  std::deque<request> requests;
+  std::deque<read_result> completed;
+  bool stopping = false;
+  std::vector<std::thread> workers;
+};
+
+#ifdef VB6_IO_URING
+
+// Every file goes through an open, then as many reads as it takes, each
+// one submitted when the previous one completes; the close is synchronous.
+// The rings are set up with the raw system calls, there is no liburing.
+class uring_file_reader final : public file_reader
+{
+public:
+  explicit uring_file_reader(std::size_t depth)
+    : slots(depth)
+  {
+    io_uring_params params{};
+    ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, static_cast<unsigned>(depth), &params));
+    if(ring_fd < 0)
+      return;
+
+    // IORING_OP_OPENAT and IORING_OP_READ came with this feature, in 5.6
+    if(!(params.features & IORING_FEAT_RW_CUR_POS) || !map_rings(params))
+    {
+      unmap_rings();
+      ::close(ring_fd);
+      ring_fd = -1;
+    }
+  }
+
+  ~uring_file_reader() override
+  {
+    if(ring_fd < 0)
+      return;
+    // the kernel must be done with our buffers before they go
+    while(in_kernel != 0)
+      reap(1);
+    for(auto& s : slots)
+    {
+      if(s.fd >= 0)
+        ::close(s.fd);
+    }
+    unmap_rings();
+    ::close(ring_fd);
+  }
+
+  bool ready() const { return ring_fd >= 0; }
+
+  char const* name() const override { return "io_uring"; }
+
+  void submit(std::size_t index, fs::path const& file) override
+  {
+    ++pending;
+    auto const free = std::find_if(slots.begin(), slots.end(), [](auto& s) { return !s.busy; });
+    if(free == slots.end())
+      backlog.push_back({ index, file, trace_clock() });
+    else
+      start(static_cast<std::size_t>(free - slots.begin()), index, file.string(), trace_clock());
+  }
+
+  bool wait(read_result& res) override
+  {
+    if(pending == 0)
+      return false;
+    while(completed.empty())
+      reap(1);
+    res = std::move(completed.front());
+    completed.pop_front();
+    --pending;
+    return true;
+  }
+
+private:
+  struct slot
+  {
+    bool busy = false;
+    std::string path;
+    int fd = -1;
+    std::size_t size = 0; // as given by fstat, 0 when unknown
+    std::size_t got = 0;
+    read_result res;
+  };
+
+  struct request
+  {
+    std::size_t index;
+    fs::path file;
+    std::uint64_t start;
+  };
+
+  template <typename T>
+  T* ring_field(void* ring, unsigned offset)
+  {
+    return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+  }
+
+  bool map_rings(io_uring_params const& params)
+  {
+    sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool const single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if(single)
+      sq_size = cq_size = std::max(sq_size, cq_size);
+
+    sq_ring = ::mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if(sq_ring == MAP_FAILED)
+      return sq_ring = nullptr, false;
+    if(single)
+      cq_ring = sq_ring;
+    else
+    {
+      cq_ring = ::mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+      if(cq_ring == MAP_FAILED)
+        return cq_ring = nullptr, false;
+    }
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    auto const entries = ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if(entries == MAP_FAILED)
+      return false;
+    sqes = static_cast<io_uring_sqe*>(entries);
+
+    sq_tail = ring_field<unsigned>(sq_ring, params.sq_off.tail);
+    sq_mask = *ring_field<unsigned>(sq_ring, params.sq_off.ring_mask);
+    sq_array = ring_field<unsigned>(sq_ring, params.sq_off.array);
+    cq_head = ring_field<unsigned>(cq_ring, params.cq_off.head);
+    cq_tail = ring_field<unsigned>(cq_ring, params.cq_off.tail);
+    cq_mask = *ring_field<unsigned>(cq_ring, params.cq_off.ring_mask);
+    cqes = ring_field<io_uring_cqe>(cq_ring, params.cq_off.cqes);
+    return true;
+  }
+
+  void unmap_rings()
+  {
+    if(sqes)
+      ::munmap(sqes, sqes_size);
+    if(cq_ring && cq_ring != sq_ring)
+      ::munmap(cq_ring, cq_size);
+    if(sq_ring)
+      ::munmap(sq_ring, sq_size);
+    sqes = nullptr;
+    sq_ring = cq_ring = nullptr;
+  }
+
+  // one operation per slot at most, so the rings never overflow
+  io_uring_sqe& queue_sqe(std::size_t s)
+  {
+    auto const tail = *sq_tail; // only we write it
+    auto const i = tail & sq_mask;
+    auto& sqe = sqes[i];
+    sqe = {};
+    sqe.user_data = s;
+    sq_array[i] = i;
+    std::atomic_ref<unsigned>(*sq_tail).store(tail + 1, std::memory_order_release);
+    ++unsubmitted;
+    ++in_kernel;
+    return sqe;
+  }
+
+  void start(std::size_t s, std::size_t index, std::string path, std::uint64_t start)
+  {
+    auto& sl = slots[s];
+    sl.busy = true;
+    sl.path = std::move(path);
+    sl.fd = -1;
+    sl.size = sl.got = 0;
+    sl.res = {};
+    sl.res.index = index;
+    sl.res.start = start;
+
+    auto& sqe = queue_sqe(s);
+    sqe.opcode = IORING_OP_OPENAT;
+    sqe.fd = AT_FDCWD;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(sl.path.c_str());
+    sqe.open_flags = O_RDONLY | O_CLOEXEC;
+  }
+
+  void read_more(std::size_t s)
+  {
+    auto& sl = slots[s];
+    auto& contents = sl.res.contents;
+    auto& sqe = queue_sqe(s);
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = sl.fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(contents.data() + sl.got);
+    sqe.len = static_cast<unsigned>(std::min<std::size_t>(contents.size() - sl.got, 1u << 30));
+    sqe.off = sl.got;
+  }
+
+  void finish(std::size_t s, bool ok)
+  {
+    auto& sl = slots[s];
+    if(sl.fd >= 0)
+      ::close(sl.fd);
+    sl.fd = -1;
+    sl.res.ok = ok;
+    sl.res.contents.resize(ok ? sl.got : 0);
+    sl.res.end = trace_clock();
+    completed.push_back(std::move(sl.res));
+    sl.busy = false;
+
+    if(!backlog.empty())
+    {
+      auto req = std::move(backlog.front());
+      backlog.pop_front();
+      start(s, req.index, req.file.string(), req.start);
+    }
+  }
+
+  void completion(std::size_t s, int result)
+  {
+    auto& sl = slots[s];
+    if(sl.fd < 0) // the open
+    {
+      if(result < 0)
+        return finish(s, false);
+      sl.fd = result;
+      struct stat st{};
+      if(::fstat(sl.fd, &st) != 0)
+        return finish(s, false);
+      sl.size = static_cast<std::size_t>(st.st_size);
+      sl.res.contents.resize(sl.size ? sl.size : 64 * 1024);
+      if(sl.size == 0 && S_ISREG(st.st_mode))
+        return finish(s, true);
+      return read_more(s);
+    }
+
+    if(result == -EINTR || result == -EAGAIN)
+      return read_more(s);
+    if(result < 0)
+      return finish(s, false);
+    if(result == 0)
+      return finish(s, true);
+    sl.got += static_cast<std::size_t>(result);
+    if(sl.got == sl.size)
+      return finish(s, true);
+    if(sl.got == sl.res.contents.size()) // it grew, or there was no size
+      sl.res.contents.resize(sl.res.contents.size() * 2);
+    read_more(s);
+  }
+
+  // submits what is queued and handles the completions
+  void reap(unsigned min_complete)
+  {
+    auto const submitted = ::syscall(__NR_io_uring_enter, ring_fd, unsubmitted, min_complete,
+                                     IORING_ENTER_GETEVENTS, nullptr, 0);
+    if(submitted > 0)
+      unsubmitted -= static_cast<unsigned>(submitted);
+
+    auto head = *cq_head; // only we write it
+    auto const tail = std::atomic_ref<unsigned>(*cq_tail).load(std::memory_order_acquire);
+    for(; head != tail; ++head)
+    {
+      auto const& cqe = cqes[head & cq_mask];
+      auto const s = static_cast<std::size_t>(cqe.user_data);
+      auto const result = cqe.res;
+      std::atomic_ref<unsigned>(*cq_head).store(head + 1, std::memory_order_release);
+      --in_kernel;
+      completion(s, result);
+    }
+  }
+
+  int ring_fd = -1;
+  void* sq_ring = nullptr;
+  void* cq_ring = nullptr;
+  std::size_t sq_size = 0;
+  std::size_t cq_size = 0;
+  std::size_t sqes_size = 0;
+  io_uring_sqe* sqes = nullptr;
+  unsigned* sq_tail = nullptr;
+  unsigned* sq_array = nullptr;
+  unsigned sq_mask = 0;
+  unsigned* cq_head = nullptr;
+  unsigned* cq_tail = nullptr;
+  unsigned cq_mask = 0;
+  io_uring_cqe* cqes = nullptr;
+
+  unsigned unsubmitted = 0; // queued in the ring, not passed to io_uring_enter yet
+  unsigned in_kernel = 0;   // operations whose completion has not been seen
+  std::vector<slot> slots;
+  std::deque<request> backlog; // more files than slots
+  std::deque<read_result> completed;
+};
+
+#endif
+
+}
+
+bool read_file(fs::path const& fname, std::string& contents)
+{
+  std::ifstream in(fname, std::ios::binary);
+  if(!in)
+    return false;
+  std::error_code ec;
+  auto const size = fs::file_size(fname, ec);
+  if(ec)
+    return false;
+  contents.resize(size);
+  in.read(contents.data(), static_cast<std::streamsize>(size));
+  contents.resize(static_cast<std::size_t>(in.gcount()));
+  return true;
+}
+
+std::unique_ptr<file_reader> make_file_reader(std::size_t depth, bool use_io_uring)
+{
+  depth = std::max<std::size_t>(depth, 1);
+#ifdef VB6_IO_URING
+  if(use_io_uring)
+  {
+    auto reader = std::make_unique<uring_file_reader>(depth);
+    if(reader->ready())
+      return reader;
+  }
+#else
+  (void)use_io_uring;
+#endif
+  return std::make_unique<thread_file_reader>(std::min<std::size_t>(depth, 16));
+}
+
+}
@@ -0,0 +1,56 @@
+//: vb6_file_reader.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace vb6_grammar {
+
+  // the whole file, synchronously
+  bool read_file(std::filesystem::path const& file, std::string& contents);
+
+  struct read_result
+  {
+    std::size_t index = 0; // as given to submit()
+    bool ok = false;
+    std::string contents;
+    std::uint64_t start = 0; // trace_clock() at submit() and at completion
+    std::uint64_t end = 0;
+  };
+
+  // Reads whole files with many reads in flight, the results come back in
+  // the order they complete. Not thread safe, meant to be driven by one
+  // loader thread.
+  class file_reader
+  {
+  public:
+    virtual ~file_reader() = default;
+
+    virtual char const* name() const = 0;
+
+    // starts reading the file, the path is copied
+    virtual void submit(std::size_t index, std::filesystem::path const& file) = 0;
+
+    // waits for a read to complete, false if none is in flight
+    virtual bool wait(read_result& res) = 0;
+
+    // submitted and not returned by wait() yet
+    std::size_t in_flight() const { return pending; }
+
+  protected:
+    std::size_t pending = 0;
+  };
+
+  // Through io_uring when the kernel has it and lets us use it (Linux 5.6 on,
+  // not always allowed in containers), else with a pool of reading threads.
+  // depth is how many files can be read at once.
+  std::unique_ptr<file_reader> make_file_reader(std::size_t depth, bool use_io_uring = true);
+}
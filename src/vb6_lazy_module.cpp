@@ -0,0 +1,104 @@
+//: vb6_lazy_module.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_lazy_module.hpp"
+#include "vb6_trace.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+namespace vb6_grammar {
+
+namespace {
+
+bool has_body(outline_kind kind)
+{
+  switch(kind)
+  {
+  case outline_kind::sub:
+  case outline_kind::function:
+  case outline_kind::property_let:
+  case outline_kind::property_set:
+  case outline_kind::property_get:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool iequals(std::string_view a, std::string_view b)
+{
+  return a.size() == b.size()
+      && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+}
+
+lazy_procedure::lazy_procedure(std::string_view unit, line_index const& lines, outline_entry entry)
+  : unit(unit), lines(lines), entry(std::move(entry))
+{
+}
+
+void lazy_procedure::materialize() const
+{
+  std::call_once(once, [this] {
+    trace_scope trace("materialize", "parse", entry.name);
+    result = phrase_parse_statements(body_source(), block);
+    result.consumed += entry.body_begin;
+    for(auto& d : result.diagnostics)
+      d.offset += entry.body_begin;
+    locate(result.diagnostics, lines);
+    done.store(true, std::memory_order_release);
+  });
+}
+
+vb6_ast::statements::statement_block const& lazy_procedure::body() const
+{
+  materialize();
+  return block;
+}
+
+parse_result const& lazy_procedure::body_result() const
+{
+  materialize();
+  return result;
+}
+
+lazy_module::lazy_module(std::string_view unit)
+  : unit(unit), index(unit)
+{
+  auto outline = parse_outline(unit);
+
+  for(auto& entry : outline.entries)
+  {
+    if(has_body(entry.kind))
+      procs.emplace_back(unit, index, std::move(entry));
+    else
+      decls.push_back(std::move(entry));
+  }
+  diags = std::move(outline.diagnostics);
+}
+
+lazy_procedure const* lazy_module::find(std::string_view name) const
+{
+  for(auto& p : procs)
+  {
+    if(iequals(p.outline().name, name))
+      return &p;
+  }
+  return nullptr;
+}
+
+std::size_t lazy_module::materialized_count() const
+{
+  return static_cast<std::size_t>(std::count_if(procs.begin(), procs.end(),
+                                                [](auto& p) { return p.materialized(); }));
+}
+
+}
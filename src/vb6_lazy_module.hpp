@@ -0,0 +1,97 @@
+//: vb6_lazy_module.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include "vb6_ast.hpp"
+#include "vb6_line_index.hpp"
+#include "vb6_outline.hpp"
+#include "vb6_parser_api.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace vb6_grammar {
+
+  // A sub, function or property whose body gets parsed the first time
+  // it is asked for. Safe to be accessed from several threads.
+  class lazy_procedure
+  {
+  public:
+    lazy_procedure(std::string_view unit, line_index const& lines, outline_entry entry);
+
+    lazy_procedure(lazy_procedure const&) = delete;
+    lazy_procedure& operator=(lazy_procedure const&) = delete;
+
+    outline_entry const& outline() const { return entry; }
+
+    std::string_view body_source() const
+    {
+      return unit.substr(entry.body_begin, entry.body_end - entry.body_begin);
+    }
+
+    bool materialized() const { return done.load(std::memory_order_acquire); }
+
+    // the body is parsed only once, by whichever thread comes first
+    vb6_ast::statements::statement_block const& body() const;
+
+    // outcome of parsing the body, consumed and the diagnostics have offsets into the unit
+    parse_result const& body_result() const;
+
+  private:
+    void materialize() const;
+
+    std::string_view unit;
+    line_index const& lines;
+    outline_entry entry;
+
+    mutable std::once_flag once;
+    mutable std::atomic<bool> done = false;
+    mutable vb6_ast::statements::statement_block block;
+    mutable parse_result result;
+  };
+
+  // Module whose procedure bodies are only recorded as spans of the source
+  // by the outline scan, see lazy_procedure.
+  // The source must outlive the module.
+  class lazy_module
+  {
+  public:
+    explicit lazy_module(std::string_view unit);
+
+    // the procedures refer to the line index of the module
+    lazy_module(lazy_module const&) = delete;
+    lazy_module& operator=(lazy_module const&) = delete;
+
+    std::string_view source() const { return unit; }
+
+    line_index const& lines() const { return index; }
+
+    std::deque<lazy_procedure> const& procedures() const { return procs; }
+
+    // declarations, events and external procedures
+    std::vector<outline_entry> const& declarations() const { return decls; }
+
+    // problems found by the outline scan, not the ones inside the bodies
+    std::vector<vb6_diagnostic> const& diagnostics() const { return diags; }
+
+    // names are compared case insensitively, as VB does
+    lazy_procedure const* find(std::string_view name) const;
+
+    std::size_t materialized_count() const;
+
+  private:
+    std::string_view unit;
+    line_index index;
+    std::deque<lazy_procedure> procs; // a deque as lazy_procedure cannot be moved
+    std::vector<outline_entry> decls;
+    std::vector<vb6_diagnostic> diags;
+  };
+}
@@ -0,0 +1,73 @@
+//: vb6_line_index.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_line_index.hpp"
+
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VB6_LINE_INDEX_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace vb6_grammar {
+
+namespace {
+
+#ifdef VB6_LINE_INDEX_SSE2
+// bit i is set when block[i] is a newline
+unsigned newline_mask(char const* block)
+{
+  __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block));
+  return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))));
+}
+#endif
+
+}
+
+std::size_t count_newlines(std::string_view buffer)
+{
+  auto const data = buffer.data();
+  auto const size = buffer.size();
+  std::size_t i = 0;
+  std::size_t count = 0;
+
+#ifdef VB6_LINE_INDEX_SSE2
+  for(; i + 16 <= size; i += 16)
+    count += static_cast<std::size_t>(std::popcount(newline_mask(data + i)));
+#endif
+
+  for(; i < size; ++i)
+    count += data[i] == '\n';
+
+  return count;
+}
+
+line_index::line_index(std::string_view buffer)
+{
+  auto const data = buffer.data();
+  auto const size = buffer.size();
+  std::size_t i = 0;
+
+  starts.reserve(count_newlines(buffer) + 1);
+  starts.push_back(0);
+
+#ifdef VB6_LINE_INDEX_SSE2
+  for(; i + 16 <= size; i += 16)
+  {
+    for(auto mask = newline_mask(data + i); mask != 0; mask &= mask - 1)
+      starts.push_back(static_cast<std::uint32_t>(i + static_cast<std::size_t>(std::countr_zero(mask)) + 1));
+  }
+#endif
+
+  for(; i < size; ++i)
+  {
+    if(data[i] == '\n')
+      starts.push_back(static_cast<std::uint32_t>(i + 1));
+  }
+}
+
+}
@@ -0,0 +1,66 @@
+//: vb6_line_index.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace vb6_grammar {
+
+  // both 1-based, the column counts bytes
+  struct line_col
+  {
+    std::size_t line = 0;
+    std::size_t column = 0;
+  };
+
+  // Offsets of the beginnings of the lines of a buffer, so that finding the
+  // line of an offset is a binary search instead of a scan of the buffer.
+  // Lines are terminated by '\n' (a preceding '\r' is part of the line).
+  class line_index
+  {
+  public:
+    line_index() = default;
+
+    // the newlines are searched 16 bytes at a time where SSE2 is available
+    explicit line_index(std::string_view buffer);
+
+    template <typename Iterator>
+    line_index(Iterator first, Iterator last)
+    {
+      starts.push_back(0);
+      std::size_t offset = 0;
+      for(; first != last; ++first)
+      {
+        ++offset;
+        if(*first == '\n')
+          starts.push_back(static_cast<std::uint32_t>(offset));
+      }
+    }
+
+    std::size_t line_count() const { return starts.size(); }
+
+    // offset of the first character of a line (1-based)
+    std::size_t line_start(std::size_t line) const { return starts[line - 1]; }
+
+    line_col position(std::size_t offset) const
+    {
+      auto const it = std::upper_bound(starts.begin(), starts.end(), offset);
+      auto const line = static_cast<std::size_t>(it - starts.begin());
+      return { line, offset - starts[line - 1] + 1 };
+    }
+
+  private:
+    std::vector<std::uint32_t> starts{};
+  };
+
+  // number of '\n' in the buffer, vectorized as the line_index constructor
+  std::size_t count_newlines(std::string_view buffer);
+}
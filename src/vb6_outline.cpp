@@ -0,0 +1,344 @@
+//: vb6_outline.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_outline.hpp"
+#include "vb6_config.hpp"
+#include "vb6_parser.hpp"
+#include "vb6_trace.hpp"
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <ostream>
+
+namespace vb6_grammar {
+
+namespace {
+
+constexpr auto npos = std::string_view::npos;
+
+// the items of a module that span several lines, up to End <keyword>
+constexpr std::string_view block_keywords[] = { "Sub", "Function", "Property", "Enum", "Type" };
+
+bool is_ident_char(char c)
+{
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+std::size_t skip_blanks(std::string_view s, std::size_t pos)
+{
+  while(pos < s.size() && (s[pos] == ' ' || s[pos] == '\t'))
+    ++pos;
+  return pos;
+}
+
+// case insensitive match of a whole word
+bool match_word(std::string_view s, std::size_t pos, std::string_view word)
+{
+  if(s.size() - pos < word.size())
+    return false;
+  for(std::size_t i = 0; i < word.size(); ++i)
+  {
+    if(std::tolower(static_cast<unsigned char>(s[pos + i])) != std::tolower(static_cast<unsigned char>(word[i])))
+      return false;
+  }
+  auto const next = pos + word.size();
+  return next == s.size() || !is_ident_char(s[next]);
+}
+
+// the line ending at eol is continued by a trailing " _"
+bool continued_line(std::string_view s, std::size_t eol)
+{
+  auto pos = eol;
+  if(pos > 0 && s[pos - 1] == '\r')
+    --pos;
+  while(pos > 0 && (s[pos - 1] == ' ' || s[pos - 1] == '\t'))
+    --pos;
+  return pos > 0 && s[pos - 1] == '_'
+      && (pos == 1 || s[pos - 2] == ' ' || s[pos - 2] == '\t');
+}
+
+// Start of the statement following the one at pos, that is after the next
+// ':' or line end which are not in a string or in a comment.
+std::size_t next_statement(std::string_view s, std::size_t pos)
+{
+  pos = skip_blanks(s, pos);
+  bool comment = match_word(s, pos, "Rem");
+
+  while(pos < s.size())
+  {
+    if(comment)
+    {
+      auto const eol = static_cast<char const*>(std::memchr(s.data() + pos, '\n', s.size() - pos));
+      if(!eol)
+        return s.size();
+      pos = static_cast<std::size_t>(eol - s.data());
+    }
+
+    switch(s[pos])
+    {
+    case '\n':
+      if(!continued_line(s, pos))
+        return pos + 1;
+      break;
+    case '"':
+      // strings never span lines, a doubled quote just closes and reopens it
+      while(++pos < s.size() && s[pos] != '"' && s[pos] != '\n')
+        ;
+      if(pos < s.size() && s[pos] == '\n')
+        continue;
+      break;
+    case '\'':
+      comment = true;
+      break;
+    case ':':
+      return pos + 1;
+    default:
+      break;
+    }
+    ++pos;
+  }
+  return s.size();
+}
+
+// excludes the statement terminator and trailing blanks from [begin, end)
+std::size_t trim_back(std::string_view s, std::size_t begin, std::size_t end)
+{
+  while(end > begin && (s[end - 1] == '\n' || s[end - 1] == '\r' || s[end - 1] == ':'
+                     || s[end - 1] == ' ' || s[end - 1] == '\t'))
+    --end;
+  return end;
+}
+
+// offset of the first "End <keyword>" statement from pos onwards
+std::size_t find_block_close(std::string_view s, std::size_t pos, std::string_view keyword)
+{
+  while(pos < s.size())
+  {
+    pos = skip_blanks(s, pos);
+    if(match_word(s, pos, "End") && match_word(s, skip_blanks(s, pos + 3), keyword))
+      return pos;
+    pos = next_statement(s, pos);
+  }
+  return npos;
+}
+
+template <class ruleType, class attrType>
+std::size_t outline_item(std::string_view unit, std::size_t start, ruleType const& rule, attrType&& attr,
+                         outline_kind kind, std::string_view block, bool skip_body,
+                         error_handler_type& error_handler, module_outline& outline)
+{
+  auto it = cbegin(unit) + start;
+  auto const nr_diags = error_handler.diagnostics().size();
+
+  auto const parser = x3::with<vb6_error_handler_tag>(std::ref(error_handler))[rule];
+
+  if(!x3::phrase_parse(it, cend(unit), parser, skip, attr))
+  {
+    if(error_handler.diagnostics().size() == nr_diags)
+      error_handler.expectation_failed(cbegin(unit) + start, rule.name);
+    if(block.empty())
+      return next_statement(unit, start);
+    auto const end = find_block_end(unit, start, block);
+    return end == npos ? unit.size() : end;
+  }
+
+  auto const body_begin = static_cast<std::size_t>(it - cbegin(unit));
+  auto body_end = body_begin;
+  auto end = body_begin;
+  if(skip_body)
+  {
+    body_end = find_block_close(unit, body_begin, block);
+    if(body_end == npos)
+    {
+      error_handler.expectation_failed(cend(unit), "End " + std::string(block));
+      body_end = end = unit.size();
+    }
+    else
+    {
+      end = next_statement(unit, body_end);
+    }
+  }
+
+  outline_entry entry;
+  entry.kind = kind;
+  entry.at = attr.at;
+  entry.name = std::move(attr.name);
+  entry.begin = static_cast<std::uint32_t>(start);
+  entry.head_end = static_cast<std::uint32_t>(trim_back(unit, start, next_statement(unit, start)));
+  entry.body_begin = static_cast<std::uint32_t>(body_begin);
+  entry.body_end = static_cast<std::uint32_t>(body_end);
+  entry.end = static_cast<std::uint32_t>(end);
+  outline.entries.push_back(std::move(entry));
+
+  return end;
+}
+
+}
+
+std::size_t find_block_end(std::string_view unit, std::size_t pos, std::string_view keyword)
+{
+  auto const close = find_block_close(unit, pos, keyword);
+  return close == npos ? npos : next_statement(unit, close);
+}
+
+module_outline parse_outline(std::string_view unit)
+{
+  trace_scope trace("parse_outline");
+
+  module_outline outline;
+
+  std::ostream discard(nullptr); // the handler never prints with this policy
+  error_handler_type error_handler(cbegin(unit), cend(unit), discard);
+  error_handler.policy(expectation_policy::diagnose);
+
+  std::size_t pos = 0;
+  while(pos < unit.size())
+  {
+    auto const start = skip_blanks(unit, pos);
+
+    // only the keywords tell what kind of item this is
+    auto kw = start;
+    for(auto modifier : { "Public", "Private", "Friend", "Global", "Static" })
+    {
+      if(match_word(unit, kw, modifier))
+      {
+        kw = skip_blanks(unit, kw + std::strlen(modifier));
+        break;
+      }
+    }
+
+    if(match_word(unit, kw, "Sub"))
+    {
+      pos = outline_item(unit, start, subHead, vb6_ast::subHead{},
+                         outline_kind::sub, "Sub", true, error_handler, outline);
+    }
+    else if(match_word(unit, kw, "Function"))
+    {
+      pos = outline_item(unit, start, functionHead, vb6_ast::functionHead{},
+                         outline_kind::function, "Function", true, error_handler, outline);
+    }
+    else if(match_word(unit, kw, "Property"))
+    {
+      auto const which = skip_blanks(unit, kw + 8);
+      if(match_word(unit, which, "Let"))
+        pos = outline_item(unit, start, property_letHead, vb6_ast::propertyLetHead{},
+                           outline_kind::property_let, "Property", true, error_handler, outline);
+      else if(match_word(unit, which, "Set"))
+        pos = outline_item(unit, start, property_setHead, vb6_ast::propertySetHead{},
+                           outline_kind::property_set, "Property", true, error_handler, outline);
+      else
+        pos = outline_item(unit, start, property_getHead, vb6_ast::propertyGetHead{},
+                           outline_kind::property_get, "Property", true, error_handler, outline);
+    }
+    else if(match_word(unit, kw, "Event"))
+    {
+      pos = outline_item(unit, start, eventHead, vb6_ast::eventHead{},
+                         outline_kind::event, "", false, error_handler, outline);
+    }
+    else if(match_word(unit, kw, "Declare"))
+    {
+      if(match_word(unit, skip_blanks(unit, kw + 7), "Sub"))
+        pos = outline_item(unit, start, external_sub_decl, vb6_ast::externalSub{},
+                           outline_kind::external_sub, "", false, error_handler, outline);
+      else
+        pos = outline_item(unit, start, external_function_decl, vb6_ast::externalFunction{},
+                           outline_kind::external_function, "", false, error_handler, outline);
+    }
+    else if(match_word(unit, kw, "Enum"))
+    {
+      pos = outline_item(unit, start, enum_declaration, vb6_ast::vb_enum{},
+                         outline_kind::enumeration, "Enum", false, error_handler, outline);
+    }
+    else if(match_word(unit, kw, "Type"))
+    {
+      pos = outline_item(unit, start, record_declaration, vb6_ast::record{},
+                         outline_kind::record, "Type", false, error_handler, outline);
+    }
+    else
+    {
+      pos = next_statement(unit, start);
+    }
+  }
+
+  outline.diagnostics = error_handler.diagnostics();
+  if(!outline.diagnostics.empty())
+    locate(outline.diagnostics, error_handler.lines());
+  return outline;
+}
+
+std::vector<std::size_t> split_module(std::string_view unit, std::size_t piece_bytes)
+{
+  std::vector<std::size_t> cuts{ 0 };
+
+  auto const outline = parse_outline(unit);
+  if(!outline.diagnostics.empty())
+    return cuts;
+
+  for(auto& entry : outline.entries)
+  {
+    if(entry.kind != outline_kind::sub && entry.kind != outline_kind::function)
+      continue;
+
+    auto const line = unit.rfind('\n', entry.begin);
+    auto const cut = line == npos ? 0 : line + 1;
+    if(cut > cuts.back() && cut - cuts.back() >= piece_bytes)
+      cuts.push_back(cut);
+  }
+  return cuts;
+}
+
+std::size_t complete_items_end(std::string_view text)
+{
+  // start of the line after the statement at pos, npos if text ends before
+  auto line_end = [text](std::size_t pos) {
+    for(;;)
+    {
+      pos = next_statement(text, pos);
+      if(pos == text.size())
+        return text.back() == '\n' && !continued_line(text, pos - 1) ? pos : npos;
+      if(text[pos - 1] == '\n')
+        return pos;
+    }
+  };
+
+  std::size_t pos = 0;
+  while(pos < text.size())
+  {
+    auto const start = skip_blanks(text, pos);
+
+    auto kw = start;
+    for(auto modifier : { "Public", "Private", "Friend", "Global", "Static" })
+    {
+      if(match_word(text, kw, modifier))
+      {
+        kw = skip_blanks(text, kw + std::strlen(modifier));
+        break;
+      }
+    }
+
+    std::size_t end = npos;
+    auto const block = std::find_if(std::begin(block_keywords), std::end(block_keywords),
+                                    [&](std::string_view k) { return match_word(text, kw, k); });
+    if(block != std::end(block_keywords))
+    {
+      auto const close = find_block_close(text, start, *block);
+      if(close != npos)
+        end = line_end(close);
+    }
+    else if(start < text.size())
+      end = line_end(start);
+
+    if(end == npos)
+      break;
+    pos = end;
+  }
+  return pos;
+}
+
+}
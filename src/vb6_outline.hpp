@@ -0,0 +1,75 @@
+//: vb6_outline.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include "vb6_ast.hpp"
+#include "vb6_error_handler.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vb6_grammar {
+
+  enum class outline_kind : std::uint8_t
+  {
+    sub,
+    function,
+    property_let,
+    property_set,
+    property_get,
+    event,
+    external_sub,
+    external_function,
+    enumeration,
+    record
+  };
+
+  // offsets into the parsed unit
+  struct outline_entry
+  {
+    outline_kind kind;
+    vb6_ast::access_type at = vb6_ast::access_type::na;
+    std::string name;
+    std::uint32_t begin = 0;      // first character of the head
+    std::uint32_t head_end = 0;   // end of the head (the signature), line terminator excluded
+    std::uint32_t body_begin = 0; // procedure body, empty for the other kinds of item
+    std::uint32_t body_end = 0;
+    std::uint32_t end = 0;        // end of the whole item, procedure body included
+  };
+
+  struct module_outline
+  {
+    std::vector<outline_entry> entries;
+    std::vector<vb6_diagnostic> diagnostics;
+  };
+
+  // Parses declarations and procedure heads only, the procedure bodies are
+  // skipped scanning for the matching End Sub/Function/Property.
+  // Items whose head does not parse are reported as diagnostics and skipped.
+  module_outline parse_outline(std::string_view unit);
+
+  // Where the unit can be cut into pieces of about piece_bytes that parse on
+  // their own, the module being the pieces' items put together: the first
+  // character of the lines of Sub and Function heads, the first cut being 0.
+  // There is no cut but 0 if the outline scan finds problems, as it could
+  // have misplaced the procedures then.
+  std::vector<std::size_t> split_module(std::string_view unit, std::size_t piece_bytes);
+
+  // End of the top-level items that are complete in text, which may be the
+  // beginning of a longer unit: the start of the line following the last one,
+  // blocks (Sub ... End Sub, Enum ... End Enum and such) included. What is
+  // before it parses as a module on its own. 0 if no item is complete yet.
+  std::size_t complete_items_end(std::string_view text);
+
+  // Offset following the line of the first "End <keyword>" statement found
+  // from pos onwards, strings and comments are not looked into.
+  // Returns std::string_view::npos if there is none.
+  std::size_t find_block_end(std::string_view unit, std::size_t pos, std::string_view keyword);
+}
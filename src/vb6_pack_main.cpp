@@ -0,0 +1,64 @@
+//: vb6_pack_main.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_archive.hpp"
+#include "vb6_batch.hpp"
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+void usage(ostream& os, char const* program)
+{
+  os << "Usage: " << program << " <archive" << vb6_grammar::archive_extension << "> <file|directory|wildcard|project.vbp>...\n"
+        "       " << program << " --list <archive" << vb6_grammar::archive_extension << ">\n"
+        "Packs the source files in one archive that vb6_parser parses from a single mapping.\n"
+        "Files under a directory given as argument, or next to a project, are named relative to it.\n";
+}
+
+int list(filesystem::path const& archive)
+{
+  vb6_grammar::archive_view const view(archive);
+  if(!view.ok())
+  {
+    cerr << view.error() << '\n';
+    return 1;
+  }
+  for(auto& e : view)
+    cout << e.contents.size() << '\t' << e.name << '\n';
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  vector<string> args(argv + 1, argv + argc);
+  if(args.size() == 2 && args[0] == "--list")
+    return list(args[1]);
+  if(args.size() < 2 || args[0].starts_with("--"))
+  {
+    usage(args.empty() || args[0] == "--help" ? cout : cerr, argv[0]);
+    return args.size() == 1 && args[0] == "--help" ? 0 : 2;
+  }
+
+  filesystem::path const archive = args[0];
+  args.erase(args.begin());
+
+  auto const inputs = vb6_grammar::collect_inputs(args, cerr);
+  if(inputs.empty())
+  {
+    cerr << "Nothing to pack\n";
+    return 1;
+  }
+  if(!vb6_grammar::write_archive(archive, inputs, vb6_grammar::archive_bases(args), cerr))
+    return 1;
+
+  cerr << "Packed " << inputs.size() << " files in " << archive.string() << '\n';
+  return 0;
+}
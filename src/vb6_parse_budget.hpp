@@ -0,0 +1,77 @@
+//: vb6_parse_budget.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+namespace vb6_grammar {
+
+  enum class parse_status
+  {
+    ok,               // the whole input was parsed
+    syntax_error,     // the parser stopped before the end of the input
+    budget_exhausted, // step or time budget ran out, the AST is partial
+    cancelled         // the cancellation token was set, the AST is partial
+  };
+
+  // Limits for a single parse, checked at every step of the statement
+  // and module loops. Zero values mean no limit.
+  struct parse_budget
+  {
+    std::size_t max_steps = 0;
+    std::chrono::steady_clock::duration max_time{};
+    std::atomic<bool> const* cancel = nullptr;
+  };
+
+  class budget_tracker
+  {
+  public:
+    void start(parse_budget const& b)
+    {
+      limits = b;
+      steps = 0;
+      state = parse_status::ok;
+      if(limits.max_time != std::chrono::steady_clock::duration::zero())
+        deadline = std::chrono::steady_clock::now() + limits.max_time;
+    }
+
+    // returns false once the parse has to be abandoned
+    bool step()
+    {
+      if(state != parse_status::ok)
+        return false;
+
+      ++steps;
+
+      if(limits.max_steps != 0 && steps > limits.max_steps)
+        state = parse_status::budget_exhausted;
+      else if(limits.cancel && limits.cancel->load(std::memory_order_relaxed))
+        state = parse_status::cancelled;
+      // reading the clock is comparatively expensive, do it every few steps
+      else if(limits.max_time != std::chrono::steady_clock::duration::zero()
+              && (steps % clock_interval) == 0
+              && std::chrono::steady_clock::now() > deadline)
+        state = parse_status::budget_exhausted;
+
+      return state == parse_status::ok;
+    }
+
+    bool stopped() const { return state != parse_status::ok; }
+    parse_status status() const { return state; }
+    std::size_t steps_taken() const { return steps; }
+
+  private:
+    static constexpr std::size_t clock_interval = 32;
+
+    parse_budget limits;
+    std::chrono::steady_clock::time_point deadline;
+    std::size_t steps = 0;
+    parse_status state = parse_status::ok;
+  };
+}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "vb6_ast.hpp"
+#include "vb6_span_table.hpp"
 
 #include <boost/spirit/home/x3.hpp>
 
@@ -69,64 +70,64 @@ namespace vb6_grammar {
 #endif
 
   struct empty_line_class              ;//: x3::annotation_base, error_handler_base {};
-  struct lonely_comment_class          ;//: x3::annotate_on_success {};
-  struct quoted_string_class           ;//: x3::annotate_on_success {};
-  struct basic_identifier_class        ;//: x3::annotate_on_success {};
-  struct decorated_variable_class      ;//: x3::annotate_on_success {};
-  struct identifier_context_class      ;//: x3::annotate_on_success {};
-  struct simple_type_identifier_class  ;//: x3::annotate_on_success {};
-  struct complex_type_identifier_class ;//: x3::annotate_on_success {};
-  struct type_identifier_class         ;//: x3::annotate_on_success {};
-  struct single_var_declaration_class  ;//: x3::annotate_on_success {};
-  struct global_var_declaration_class  ;//: x3::annotate_on_success {};
-  struct record_declaration_class      ;//: x3::annotate_on_success {};
-  struct const_expression_class        ;//: x3::annotate_on_success {};
-  struct expression_class              ;//: x3::annotate_on_success {};
-  struct enum_declaration_class        ;//: x3::annotate_on_success {};
-  struct const_var_declaration_class   ;//: x3::annotate_on_success {};
-  struct param_decl_class              ;//: x3::annotate_on_success {};
-  struct external_sub_decl_class       ;//: x3::annotate_on_success {};
-  struct external_function_decl_class  ;//: x3::annotate_on_success {};
-  struct subHead_class                 ;//: x3::annotate_on_success {};
-  struct eventHead_class               ;//: x3::annotate_on_success {};
-  struct functionHead_class            ;//: x3::annotate_on_success {};
-  struct subDef_class                  ;//: x3::annotate_on_success {};
-  struct functionDef_class             ;//: x3::annotate_on_success {};
-  struct propertyDef_class             ;//: x3::annotate_on_success {};
-  struct functionCall_class            ;//: x3::annotate_on_success {};
-  struct property_letHead_class        ;//: x3::annotate_on_success {};
-  struct property_setHead_class        ;//: x3::annotate_on_success {};
-  struct property_getHead_class        ;//: x3::annotate_on_success {};
-  struct attributeDef_class            ;//: x3::annotate_on_success {};
-  struct option_item_class             ;//: x3::annotate_on_success {};
+  struct lonely_comment_class           : annotate_span {};
+  struct quoted_string_class            : annotate_span {};
+  struct basic_identifier_class         : annotate_span {};
+  struct decorated_variable_class       : annotate_span {};
+  struct identifier_context_class       : annotate_span {};
+  struct simple_type_identifier_class   : annotate_span {};
+  struct complex_type_identifier_class  : annotate_span {};
+  struct type_identifier_class          : annotate_span {};
+  struct single_var_declaration_class   : annotate_span {};
+  struct global_var_declaration_class   : annotate_span {};
+  struct record_declaration_class       : annotate_span {};
+  struct const_expression_class         : annotate_span {};
+  struct expression_class               : annotate_span {};
+  struct enum_declaration_class         : annotate_span {};
+  struct const_var_declaration_class    : annotate_span {};
+  struct param_decl_class               : annotate_span {};
+  struct external_sub_decl_class        : annotate_span {};
+  struct external_function_decl_class   : annotate_span {};
+  struct subHead_class                  : annotate_span {};
+  struct eventHead_class                : annotate_span {};
+  struct functionHead_class             : annotate_span {};
+  struct subDef_class                   : annotate_span {};
+  struct functionDef_class              : annotate_span {};
+  struct propertyDef_class              : annotate_span {};
+  struct functionCall_class             : annotate_span {};
+  struct property_letHead_class         : annotate_span {};
+  struct property_setHead_class         : annotate_span {};
+  struct property_getHead_class         : annotate_span {};
+  struct attributeDef_class             : annotate_span {};
+  struct option_item_class              : annotate_span {};
 
   namespace statements {
-    struct singleStmt_class      ;//: x3::annotate_on_success {};
-    struct statement_block_class ;//: x3::annotate_on_success {};
-    struct assignmentStmt_class  ;//: x3::annotate_on_success {};
-    struct localvardeclStmt_class;//: x3::annotate_on_success {};
-    struct redimStmt_class       ;//: x3::annotate_on_success {};
-    struct exitStmt_class        ;//: x3::annotate_on_success {};
-    struct gotoStmt_class        ;//: x3::annotate_on_success {};
-    struct onerrorStmt_class     ;//: x3::annotate_on_success {};
-    struct resumeStmt_class      ;//: x3::annotate_on_success {};
-    struct labelStmt_class       ;//: x3::annotate_on_success {};
-    struct callimplicitStmt_class;//: x3::annotate_on_success {};
-    struct callexplicitStmt_class;//: x3::annotate_on_success {};
-    struct raiseeventStmt_class  ;//: x3::annotate_on_success {};
+    struct singleStmt_class       : annotate_span {};
+    struct statement_block_class  : annotate_span {};
+    struct assignmentStmt_class   : annotate_span {};
+    struct localvardeclStmt_class : annotate_span {};
+    struct redimStmt_class        : annotate_span {};
+    struct exitStmt_class         : annotate_span {};
+    struct gotoStmt_class         : annotate_span {};
+    struct onerrorStmt_class      : annotate_span {};
+    struct resumeStmt_class       : annotate_span {};
+    struct labelStmt_class        : annotate_span {};
+    struct callimplicitStmt_class : annotate_span {};
+    struct callexplicitStmt_class : annotate_span {};
+    struct raiseeventStmt_class   : annotate_span {};
 
     // compound statements
-    struct whileStmt_class       ;//: x3::annotate_on_success {};
-    struct doStmt_class          ;//: x3::annotate_on_success {};
-    struct dowhileStmt_class     ;//: x3::annotate_on_success {};
-    struct loopwhileStmt_class   ;//: x3::annotate_on_success {};
-    struct dountilStmt_class     ;//: x3::annotate_on_success {};
-    struct loopuntilStmt_class   ;//: x3::annotate_on_success {};
-    struct forStmt_class         ;//: x3::annotate_on_success {};
-    struct foreachStmt_class     ;//: x3::annotate_on_success {};
-    struct ifelseStmt_class      ;//: x3::annotate_on_success {};
-    struct withStmt_class        ;//: x3::annotate_on_success {};
-    struct selectStmt_class      ;//: x3::annotate_on_success {};
+    struct whileStmt_class        : annotate_span {};
+    struct doStmt_class           : annotate_span {};
+    struct dowhileStmt_class      : annotate_span {};
+    struct loopwhileStmt_class    : annotate_span {};
+    struct dountilStmt_class      : annotate_span {};
+    struct loopuntilStmt_class    : annotate_span {};
+    struct forStmt_class          : annotate_span {};
+    struct foreachStmt_class      : annotate_span {};
+    struct ifelseStmt_class       : annotate_span {};
+    struct withStmt_class         : annotate_span {};
+    struct selectStmt_class       : annotate_span {};
   }
 
   using empty_line_type              = x3::rule<empty_line_class,              vb6_ast::empty_line>;
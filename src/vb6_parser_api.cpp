@@ -0,0 +1,224 @@
+//: vb6_parser_api.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_parser_api.hpp"
+#include "vb6_config.hpp"
+#include "vb6_parser.hpp"
+#include "vb6_probes.hpp"
+#include "vb6_trace.hpp"
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+namespace vb6_grammar {
+
+namespace {
+
+// The iterators the text gets parsed with: contiguous text through the
+// pointer instantiation of the rules, text in pieces through the rope one.
+std::pair<pointer_iterator, pointer_iterator> bounds(std::string_view text)
+{
+  return { text.data(), text.data() + text.size() };
+}
+
+std::pair<rope_iterator, rope_iterator> bounds(piece_text const& text)
+{
+  return { text.begin(), text.end() };
+}
+
+// the diagnostics of result are the ones of the handler, swapped out of it
+template <typename Iterator>
+void make_result(parse_result& result, Iterator it1, Iterator it2, bool res,
+                 vb6_error_handler<Iterator>& error_handler)
+{
+  result.consumed = error_handler.offset_of(it1);
+  error_handler.swap_diagnostics(result.diagnostics);
+  if(!result.diagnostics.empty())
+    locate(result.diagnostics, error_handler.lines());
+
+  if(error_handler.budget().stopped())
+    result.status = error_handler.budget().status();
+  else if(!res || it1 != it2)
+    result.status = parse_status::syntax_error;
+  else
+    result.status = parse_status::ok;
+}
+
+// The error handler never writes to out, it only records diagnostics. The
+// capacity of result.diagnostics gets reused.
+template <class Text, class ruleType, class attrType>
+void phrase_parse_budgeted(parse_result& result, std::ostream& out, Text const& input,
+                           ruleType const& rule, attrType& ast, parse_budget const& budget,
+                           span_table* spans = nullptr, coverage_counters* coverage = nullptr)
+{
+  trace_scope trace("phrase_parse", "parse", rule.name);
+  VB6_PROBE(parse__start, rule.name, input.size());
+  [[maybe_unused]] auto const start = VB6_PROBE_ENABLED(parse__done) ? trace_clock() : 0;
+
+  auto [it1, it2] = bounds(input);
+
+  vb6_error_handler<decltype(it1)> error_handler(it1, it2, out);
+  error_handler.policy(expectation_policy::diagnose);
+  error_handler.budget().start(budget);
+  error_handler.spans(spans);
+  error_handler.coverage(coverage);
+  result.diagnostics.clear();
+  error_handler.swap_diagnostics(result.diagnostics);
+
+  auto const parser = x3::with<vb6_error_handler_tag>(std::ref(error_handler))[rule];
+
+  bool const res = x3::phrase_parse(it1, it2, parser, skip, ast);
+
+  make_result(result, it1, it2, res, error_handler);
+  // the arguments of a probe are evaluated even with nothing attached
+  if(VB6_PROBE_ENABLED(parse__done))
+    VB6_PROBE(parse__done, rule.name, result.consumed, static_cast<int>(result.status), trace_clock() - start);
+}
+
+template <class Text, class ruleType, class attrType>
+parse_result phrase_parse_budgeted(Text const& input, ruleType const& rule, attrType& ast,
+                                   parse_budget const& budget, span_table* spans = nullptr,
+                                   coverage_counters* coverage = nullptr)
+{
+  parse_result result;
+  std::ostream discard(nullptr);
+  phrase_parse_budgeted(result, discard, input, rule, ast, budget, spans, coverage);
+  return result;
+}
+
+void recognize(parse_result& result, std::ostream& out, std::string_view unit, parse_budget const& budget)
+{
+  trace_scope trace("check_syntax");
+  VB6_PROBE(parse__start, "check_syntax", unit.size());
+  [[maybe_unused]] auto const start = VB6_PROBE_ENABLED(parse__done) ? trace_clock() : 0;
+
+  auto [it1, it2] = bounds(unit);
+
+  vb6_error_handler<pointer_iterator> error_handler(it1, it2, out);
+  error_handler.policy(expectation_policy::diagnose);
+  error_handler.budget().start(budget);
+  result.diagnostics.clear();
+  error_handler.swap_diagnostics(result.diagnostics);
+
+  auto const parser = x3::with<vb6_recognizer_tag>(std::true_type{})[
+                        x3::with<vb6_error_handler_tag>(std::ref(error_handler))[basModDef]];
+
+  bool const res = x3::phrase_parse(it1, it2, parser, skip);
+
+  make_result(result, it1, it2, res, error_handler);
+  if(VB6_PROBE_ENABLED(parse__done))
+    VB6_PROBE(parse__done, "check_syntax", result.consumed, static_cast<int>(result.status), trace_clock() - start);
+}
+
+}
+
+parsed_module parse_module(std::string_view unit, parse_options const& options)
+{
+  parsed_module parsed;
+  std::ostream discard(nullptr);
+  phrase_parse_budgeted(parsed.result, discard, unit, basModDef, parsed.ast, options.budget,
+                        options.spans ? &parsed.spans : nullptr);
+  return parsed;
+}
+
+parse_result phrase_parse_module(std::string_view unit, vb6_ast::vb_module& ast,
+                                 parse_budget const& budget)
+{
+  return phrase_parse_budgeted(unit, basModDef, ast, budget);
+}
+
+parsed_module parse_module(piece_text const& text, parse_options const& options)
+{
+  parsed_module parsed;
+  std::ostream discard(nullptr);
+  phrase_parse_budgeted(parsed.result, discard, text, basModDef, parsed.ast, options.budget,
+                        options.spans ? &parsed.spans : nullptr);
+  return parsed;
+}
+
+parse_result phrase_parse_module(piece_text const& text, vb6_ast::vb_module& ast, parse_budget const& budget)
+{
+  return phrase_parse_budgeted(text, basModDef, ast, budget);
+}
+
+parse_result phrase_parse_module(std::string_view unit, vb6_ast::vb_module& ast, span_table& spans,
+                                 parse_budget const& budget)
+{
+  return phrase_parse_budgeted(unit, basModDef, ast, budget, &spans);
+}
+
+parse_result phrase_parse_module(std::string_view unit, vb6_ast::vb_module& ast, coverage_counters& coverage,
+                                 parse_budget const& budget)
+{
+  return phrase_parse_budgeted(unit, basModDef, ast, budget, nullptr, &coverage);
+}
+
+parse_result phrase_parse_statements(std::string_view block, vb6_ast::statements::statement_block& ast,
+                                     parse_budget const& budget)
+{
+  return phrase_parse_budgeted(block, statements::statement_block, ast, budget);
+}
+
+parse_result check_syntax(std::string_view unit, parse_budget const& budget)
+{
+  parse_result result;
+  std::ostream discard(nullptr);
+  recognize(result, discard, unit, budget);
+  return result;
+}
+
+parse_session::parse_session()
+  : discard(nullptr)
+{
+}
+
+parse_result const& parse_session::parse_module(std::string_view unit, vb6_ast::vb_module& ast,
+                                                parse_budget const& budget)
+{
+  phrase_parse_budgeted(last, discard, unit, basModDef, ast, budget);
+  return last;
+}
+
+parse_result const& parse_session::parse_module(std::string_view unit, parse_budget const& budget)
+{
+  module_ast.clear();
+  return parse_module(unit, module_ast, budget);
+}
+
+parse_result const& parse_session::parse_unit(std::string_view unit, unit_layout const& layout,
+                                              vb6_ast::vb_module& ast, parse_budget const& budget)
+{
+  // every kind of unit has the code of a module after its header, so this
+  // is one parse whatever the kind, the header being skipped
+  phrase_parse_budgeted(last, discard, unit.substr(layout.code_begin), basModDef, ast, budget);
+
+  // the code starts at the beginning of a line, so only the line moves
+  last.consumed += layout.code_begin;
+  for(auto& d : last.diagnostics)
+  {
+    d.offset += layout.code_begin;
+    d.where.line += layout.code_line;
+  }
+  return last;
+}
+
+parse_result const& parse_session::parse_statements(std::string_view block, parse_budget const& budget)
+{
+  block_ast.clear();
+  phrase_parse_budgeted(last, discard, block, statements::statement_block, block_ast, budget);
+  return last;
+}
+
+parse_result const& parse_session::check_syntax(std::string_view unit, parse_budget const& budget)
+{
+  recognize(last, discard, unit, budget);
+  return last;
+}
+
+}
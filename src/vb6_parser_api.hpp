@@ -0,0 +1,135 @@
+//: vb6_parser_api.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include "vb6_ast.hpp"
+#include "vb6_coverage.hpp"
+#include "vb6_error_handler.hpp"
+#include "vb6_parse_budget.hpp"
+#include "vb6_piece_table.hpp"
+#include "vb6_span_table.hpp"
+#include "vb6_unit.hpp"
+
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace vb6_grammar {
+
+  struct parse_result
+  {
+    parse_status status = parse_status::ok;
+    std::size_t consumed = 0; // bytes of the input covered by the AST
+    std::vector<vb6_diagnostic> diagnostics;
+  };
+
+  // These entry points never throw on malformed input, expectation failures
+  // are returned as diagnostics. When the budget runs out or the parse gets
+  // cancelled the AST holds what had been completely parsed until then.
+  //
+  // They are reentrant and can be called from any number of threads at once
+  // (test/vb6_parser_stress.gtest.cpp checks it under ThreadSanitizer): the
+  // rules are const objects built during the static initialization, and the
+  // error handler, budget, spans and diagnostics put in the parser context
+  // with x3::with are local to the call. The state shared by all the parses,
+  // the registry of coverage sites and the trace buffers, is locked. What
+  // gets passed in (ASTs, span tables, coverage counters, sessions) must not
+  // be used by two parses at once.
+
+  struct parse_options
+  {
+    parse_budget budget;
+    bool spans = false; // record the location of the AST nodes in parsed_module::spans
+  };
+
+  struct parsed_module
+  {
+    vb6_ast::vb_module ast;
+    span_table spans;
+    parse_result result;
+  };
+
+  // the entry point meant for the users of the library
+  parsed_module parse_module(std::string_view unit, parse_options const& options = {});
+
+  // Text kept in pieces, as by an editor, gets parsed where it is through
+  // the instantiation of the rules for piece_iterator. Contiguous text is
+  // faster to parse, see the piece_table benchmarks.
+  parsed_module parse_module(piece_text const& text, parse_options const& options = {});
+
+  parse_result phrase_parse_module(piece_text const& text, vb6_ast::vb_module& ast,
+                                   parse_budget const& budget = {});
+
+  parse_result phrase_parse_module(std::string_view unit, vb6_ast::vb_module& ast,
+                                   parse_budget const& budget = {});
+
+  // same as above, also recording the location of the AST nodes in spans
+  parse_result phrase_parse_module(std::string_view unit, vb6_ast::vb_module& ast, span_table& spans,
+                                   parse_budget const& budget = {});
+
+  // same as above, adding to coverage the alternatives of the grammar that got used
+  parse_result phrase_parse_module(std::string_view unit, vb6_ast::vb_module& ast, coverage_counters& coverage,
+                                   parse_budget const& budget = {});
+
+  parse_result phrase_parse_statements(std::string_view block, vb6_ast::statements::statement_block& ast,
+                                       parse_budget const& budget = {});
+
+  // Only recognizes the unit, no AST gets built. On valid input nothing is
+  // allocated, so this is the cheap way of telling whether a file parses.
+  parse_result check_syntax(std::string_view unit, parse_budget const& budget = {});
+
+  // What a parse needs besides its input, kept from one parse to the next by
+  // a thread parsing many units or snippets: the stream of the error
+  // handler, the buffer of the diagnostics and the ASTs, whose capacity gets
+  // reused. So a small snippet costs its parse rather than the setting up.
+  // The error handler is still built for every parse, being a few
+  // iterators and empty containers: about 9 ns, next to about 9 us for a
+  // one-line statement, where half the time goes in trying the keywords of
+  // the statements that do not match (x3's no_case string_parse).
+  // Not thread safe, meant to be one per thread.
+  class parse_session
+  {
+  public:
+    parse_session();
+
+    parse_session(parse_session const&) = delete;
+    parse_session& operator=(parse_session const&) = delete;
+
+    // The same as the functions above, the results being valid until the
+    // next parse of the session.
+
+    parse_result const& parse_module(std::string_view unit, vb6_ast::vb_module& ast,
+                                     parse_budget const& budget = {});
+
+    // into module(), emptied first
+    parse_result const& parse_module(std::string_view unit, parse_budget const& budget = {});
+
+    // A whole .bas, .cls, .frm or .ctl file laid out by sniff_unit: only its
+    // code gets parsed, once, the offsets and lines of the diagnostics and
+    // consumed being still those of the file.
+    parse_result const& parse_unit(std::string_view unit, unit_layout const& layout, vb6_ast::vb_module& ast,
+                                   parse_budget const& budget = {});
+
+    // into statements(), emptied first
+    parse_result const& parse_statements(std::string_view block, parse_budget const& budget = {});
+
+    parse_result const& check_syntax(std::string_view unit, parse_budget const& budget = {});
+
+    vb6_ast::vb_module& module() { return module_ast; }
+    vb6_ast::statements::statement_block& statements() { return block_ast; }
+
+    // of the last parse
+    parse_result const& result() const { return last; }
+
+  private:
+    std::ostream discard; // given to the error handler, which only records diagnostics
+    parse_result last;
+    vb6_ast::vb_module module_ast;
+    vb6_ast::statements::statement_block block_ast;
+  };
+}
@@ -0,0 +1,52 @@
+//: vb6_parser_checkpoint.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include "vb6_error_handler.hpp"
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <type_traits>
+
+namespace vb6_grammar {
+
+  namespace x3 = boost::spirit::x3;
+
+  // Consumes nothing, it charges one step to the budget of the error handler
+  // found in the context and fails once the budget is exhausted or the parse
+  // has been cancelled. Placed at the head of the repeating rules it makes
+  // them stop, leaving what has been parsed so far in the attribute.
+  struct checkpoint_parser : x3::parser<checkpoint_parser>
+  {
+    using attribute_type = x3::unused_type;
+    static bool const has_attribute = false;
+
+    template <typename Iterator, typename Context, typename RContext, typename Attribute>
+    bool parse(Iterator& /*first*/, Iterator const& /*last*/,
+               Context const& context, RContext&, Attribute&) const
+    {
+      auto& handler = x3::get<vb6_error_handler_tag>(context);
+
+      if constexpr(std::is_same_v<std::decay_t<decltype(handler)>, x3::unused_type>)
+        return true;
+      else
+        return handler.get().budget().step();
+    }
+  };
+
+  checkpoint_parser const checkpoint{};
+}
+
+namespace boost::spirit::x3 {
+
+  template <>
+  struct get_info<vb6_grammar::checkpoint_parser>
+  {
+    using result_type = std::string;
+    std::string operator()(vb6_grammar::checkpoint_parser const&) const { return "checkpoint"; }
+  };
+}
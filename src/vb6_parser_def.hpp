@@ -8,8 +8,13 @@
 
 #include "vb6_parser.hpp"
 #include "vb6_ast_adapt.hpp"
+#include "vb6_coverage.hpp"
+#include "vb6_parser_checkpoint.hpp"
+#include "vb6_parser_define.hpp"
+#include "vb6_parser_expect.hpp"
 #include "vb6_parser_keywords.hpp"
 #include "vb6_parser_operators.hpp"
+#include "vb6_trace.hpp"
 
 #include <boost/fusion/include/std_pair.hpp>
 #include <boost/spirit/home/x3.hpp>
@@ -50,11 +55,11 @@ namespace vb6_grammar {
   auto const cmdTermin = x3::eol | ':';
 
   // keyword groups
-  auto const kwgEndType     = kwEnd > kwType     > cmdTermin;
-  auto const kwgEndEnum     = kwEnd > kwEnum     > cmdTermin;
-  auto const kwgEndFunction = kwEnd > kwFunction > cmdTermin;
-  auto const kwgEndSub      = kwEnd > kwSub      > cmdTermin;
-  auto const kwgEndProperty = kwEnd > kwProperty > cmdTermin;
+  auto const kwgEndType     = kwEnd >> expect("Type")[kwType]     >> expect("end of statement")[cmdTermin];
+  auto const kwgEndEnum     = kwEnd >> expect("Enum")[kwEnum]     >> expect("end of statement")[cmdTermin];
+  auto const kwgEndFunction = kwEnd >> expect("Function")[kwFunction] >> expect("end of statement")[cmdTermin];
+  auto const kwgEndSub      = kwEnd >> expect("Sub")[kwSub]      >> expect("end of statement")[cmdTermin];
+  auto const kwgEndProperty = kwEnd >> expect("Property")[kwProperty] >> expect("end of statement")[cmdTermin];
 
   auto const bool_const = x3::rule<class bool_const, bool>("bool_const")
                         = (kwTrue  >> x3::attr(true))
@@ -194,18 +199,18 @@ namespace vb6_grammar {
   x3::real_parser<float, x3::strict_real_policies<float>> const float_ = {};
   //x3::real_parser<double, x3::strict_real_policies<double>> const double_ = {};
 
-  auto const const_expression_def = double_float
-                                  | single_float
-                                  | float_
-                                  | long_dec
-                                  | long_hex
-                                  | long_oct
-                                  | integer_dec
-                                  | integer_hex
-                                  | integer_oct
-                                  | quoted_string
-                                  | bool_const
-                                  | (kwNothing >> x3::attr(vb6_ast::nothing()));
+  auto const const_expression_def = cover("const_expression")[double_float]
+                                  | cover("const_expression")[single_float]
+                                  | cover("const_expression", "float_")[float_]
+                                  | cover("const_expression")[long_dec]
+                                  | cover("const_expression")[long_hex]
+                                  | cover("const_expression")[long_oct]
+                                  | cover("const_expression")[integer_dec]
+                                  | cover("const_expression")[integer_hex]
+                                  | cover("const_expression")[integer_oct]
+                                  | cover("const_expression")[quoted_string]
+                                  | cover("const_expression")[bool_const]
+                                  | cover("const_expression", "Nothing")[kwNothing >> x3::attr(vb6_ast::nothing())];
 
   namespace expr_take_1
   {
@@ -322,13 +327,13 @@ namespace vb6_grammar {
   auto const functionHead_def = private_or_public >> kwFunction >> func_identifier
                              >> '(' >> param_list_decl >> ')' >> -(kwAs >> type_identifier)
                              >> cmdTermin;
-  auto const property_letHead_def = private_or_public >> (kwProperty > kwLet) >> prop_identifier
+  auto const property_letHead_def = private_or_public >> (kwProperty >> expect("Let")[kwLet]) >> prop_identifier
                                  >> '(' >> param_list_decl >> ')'
                                  >> cmdTermin;
-  auto const property_setHead_def = private_or_public >> (kwProperty > kwSet) >> prop_identifier
+  auto const property_setHead_def = private_or_public >> (kwProperty >> expect("Set")[kwSet]) >> prop_identifier
                                  >> '(' >> param_list_decl >> ')'
                                  >> cmdTermin;
-  auto const property_getHead_def = private_or_public >> (kwProperty > kwGet) >> prop_identifier
+  auto const property_getHead_def = private_or_public >> (kwProperty >> expect("Get")[kwGet]) >> prop_identifier
                                  >> '(' >> param_list_decl >> ')' >> -(kwAs >> type_identifier)
                                  >> cmdTermin;;
 
@@ -355,13 +360,13 @@ namespace vb6_grammar {
                              >> attr_name >> opEqual >> quoted_string
                              >> cmdTermin;
 
-  auto const option_item_def = kwOption > ( (kwExplicit              >> x3::attr(vb6_ast::module_option::explicit_))
-                                          | (kwCompare > ((kwText    >> x3::attr(vb6_ast::module_option::compare_text)) |
-                                                          (kwBinary  >> x3::attr(vb6_ast::module_option::compare_binary))))
-                                          | (kwBase > ((x3::lit('0') >> x3::attr(vb6_ast::module_option::base_0)) |
-                                                       (x3::lit('1') >> x3::attr(vb6_ast::module_option::base_1))))
-                                          | ((kwPrivate > kwModule)  >> x3::attr(vb6_ast::module_option::private_module))
-                                          ) >> cmdTermin;
+  auto const option_item_def = kwOption >> expect("Explicit, Compare, Base or Private Module")[ ( (kwExplicit                      >> x3::attr(vb6_ast::module_option::explicit_))
+                                                   | (kwCompare >> expect("Text or Binary")[(kwText    >> x3::attr(vb6_ast::module_option::compare_text)) |
+                                                                          (kwBinary  >> x3::attr(vb6_ast::module_option::compare_binary))])
+                                                   | (kwBase >> expect("0 or 1")[(x3::lit('0') >> x3::attr(vb6_ast::module_option::base_0)) |
+                                                                       (x3::lit('1') >> x3::attr(vb6_ast::module_option::base_1))])
+                                                   | ((kwPrivate >> expect("Module")[kwModule]) >> x3::attr(vb6_ast::module_option::private_module))
+                                                   ) >> cmdTermin];
 
   namespace STRICT_MODULE_STRUCTURE
   {
@@ -400,15 +405,13 @@ namespace vb6_grammar {
                            ;
 
     auto const basModDef_def = preamble
-                            >> (*declaration)
-                            >> (*func_subDef);
-    auto const clsModDef = preamble >> *declaration >> *func_subDef;
-    auto const frmModDef = preamble >> /*formDef >>*/ *declaration >> *func_subDef;
-    auto const ctlModDef = preamble >> /*formDef >>*/ *declaration >> *func_subDef;
+                            >> (*(checkpoint >> declaration))
+                            >> (*(checkpoint >> func_subDef));
+    // Classes, forms and user controls are modules after the header of the
+    // designer, which sniff_unit skips (see vb6_unit.hpp), so basModDef is
+    // the rule of every kind of unit.
 
-    auto const unitDef = basModDef | clsModDef | frmModDef | ctlModDef;
-
-    BOOST_SPIRIT_DEFINE(
+    VB6_SPIRIT_DEFINE(
         declaration
       , basModDef
     )
@@ -423,21 +426,20 @@ namespace vb6_grammar {
                              | eventHead
                              ;
 
-  auto const func_subDef = subDef
-                         | functionDef
+  auto const func_subDef = traced("procedure")[subDef]
+                         | traced("procedure")[functionDef]
                          //| propertyDef
                          ;
 
-  auto const basModDef_def = *(lonely_comment // critical to have this as the first element
-                           | empty_line
-                           | attributeDef
-                           | option_item
-                           | declaration
-                           | func_subDef);
-
-  auto const unitDef = basModDef;
+  auto const basModDef_def = *(checkpoint
+                           >> ( lonely_comment // critical to have this as the first element
+                              | empty_line
+                              | attributeDef
+                              | option_item
+                              | traced("declaration")[declaration]
+                              | func_subDef));
 
-  BOOST_SPIRIT_DEFINE(
+  VB6_SPIRIT_DEFINE(
       empty_line
     , lonely_comment
     , quoted_string
@@ -0,0 +1,51 @@
+//: vb6_parser_define.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <boost/preprocessor/cat.hpp>
+#include <boost/preprocessor/seq/for_each.hpp>
+#include <boost/preprocessor/variadic/to_seq.hpp>
+#include <boost/spirit/home/x3.hpp>
+
+#include <type_traits>
+#include <utility>
+
+namespace vb6_grammar {
+
+  namespace x3 = boost::spirit::x3;
+
+  // tag found in the context of recognizer-only parses (see check_syntax)
+  struct vb6_recognizer_tag;
+
+  template <typename Context>
+  constexpr bool is_recognizer_context =
+    std::is_same_v<std::decay_t<decltype(x3::get<vb6_recognizer_tag>(std::declval<Context const&>()))>,
+                   std::true_type>;
+}
+
+// Same as BOOST_SPIRIT_DEFINE, except that in a recognizer context the rule
+// definition is run with an unused attribute: nothing is synthesized, not even
+// in the rules called from it, so only the syntax gets checked.
+#define VB6_SPIRIT_DEFINE_(r, data, rule_name)                                   \
+  template <typename Iterator, typename Context>                                 \
+  inline bool parse_rule(                                                        \
+      decltype(rule_name) /* rule_ */                                            \
+    , Iterator& first, Iterator const& last                                      \
+    , Context const& context, decltype(rule_name)::attribute_type& attr)         \
+  {                                                                              \
+    using boost::spirit::x3::unused;                                             \
+    static auto const def_ = (rule_name = BOOST_PP_CAT(rule_name, _def));        \
+    if constexpr(vb6_grammar::is_recognizer_context<Context>)                    \
+      return def_.parse(first, last, context, unused, unused);                   \
+    else                                                                         \
+      return def_.parse(first, last, context, unused, attr);                     \
+  }                                                                              \
+  /***/
+
+#define VB6_SPIRIT_DEFINE(...) BOOST_PP_SEQ_FOR_EACH(                            \
+  VB6_SPIRIT_DEFINE_, _, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__))                  \
+  /***/
@@ -0,0 +1,114 @@
+//: vb6_parser_expect.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include "vb6_error_handler.hpp"
+#include "vb6_probes.hpp"
+
+#include <boost/spirit/home/x3.hpp>
+#include <boost/spirit/home/x3/core/detail/parse_into_container.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <string>
+#include <type_traits>
+
+namespace vb6_grammar {
+
+  namespace x3 = boost::spirit::x3;
+
+  // Drop-in replacement for x3::expect (and so for the '>' operator).
+  // When the error handler found in the context asks for it, a failed
+  // expectation is recorded as a diagnostic and the parser just fails,
+  // otherwise x3::expectation_failure is thrown as usual.
+  // What was expected is told by the label, as in expect("End Sub")[...],
+  // since x3::what names the parsers that are not rules by their type.
+  template <typename Iterator, typename Context>
+  bool expectation_failed(Iterator const& first, Iterator const& last, std::string which, Context const& context)
+  {
+    auto& handler = x3::get<vb6_error_handler_tag>(context);
+
+    if constexpr(!std::is_same_v<std::decay_t<decltype(handler)>, x3::unused_type>)
+    {
+      auto& error_handler = handler.get();
+
+      // the subject failed because the parse is being abandoned, not a syntax error
+      if(error_handler.budget().stopped())
+        return false;
+      VB6_PROBE(expectation__failed, error_handler.offset_of(first), which.c_str());
+
+      if(error_handler.policy() == expectation_policy::diagnose)
+      {
+        // point the diagnostic at the offending token, not at the whitespace before it
+        Iterator where = first;
+        x3::skip_over(where, last, context);
+        error_handler.expectation_failed(where, std::move(which));
+        return false;
+      }
+    }
+
+    boost::throw_exception(x3::expectation_failure<Iterator>(first, which));
+  }
+
+  template <typename Subject>
+  struct expect_directive : x3::unary_parser<Subject, expect_directive<Subject>>
+  {
+    using base_type = x3::unary_parser<Subject, expect_directive<Subject>>;
+    static bool const is_pass_through_unary = true;
+
+    constexpr expect_directive(Subject const& subject, char const* label)
+      : base_type(subject), label(label) {}
+
+    // what the diagnostics say is expected
+    std::string which() const { return label ? std::string(label) : x3::what(this->subject); }
+
+    char const* label;
+
+    template <typename Iterator, typename Context, typename RContext, typename Attribute>
+    bool parse(Iterator& first, Iterator const& last,
+               Context const& context, RContext& rcontext, Attribute& attr) const
+    {
+      if(this->subject.parse(first, last, context, rcontext, attr))
+        return true;
+
+      return expectation_failed(first, last, which(), context);
+    }
+  };
+
+  struct expect_gen
+  {
+    template <typename Subject>
+    constexpr expect_directive<typename x3::extension::as_parser<Subject>::value_type>
+    operator[](Subject const& subject) const
+    {
+      return { x3::as_parser(subject), label };
+    }
+
+    constexpr expect_gen operator()(char const* what) const { return { what }; }
+
+    char const* label = nullptr;
+  };
+
+  constexpr auto expect = expect_gen{};
+}
+
+namespace boost::spirit::x3::detail {
+
+  template <typename Subject, typename Context, typename RContext>
+  struct parse_into_container_impl<vb6_grammar::expect_directive<Subject>, Context, RContext>
+  {
+    template <typename Iterator, typename Attribute>
+    static bool call(vb6_grammar::expect_directive<Subject> const& parser,
+                     Iterator& first, Iterator const& last,
+                     Context const& context, RContext& rcontext, Attribute& attr)
+    {
+      if(parse_into_container(parser.subject, first, last, context, rcontext, attr))
+        return true;
+
+      return vb6_grammar::expectation_failed(first, last, parser.which(), context);
+    }
+  };
+}
@@ -5,13 +5,25 @@
 // This code is licensed under GNU Software License (see LICENSE.txt for details)
 
 #include "color_console.hpp"
+#include "vb6_alloc_hook.hpp"
+#include "vb6_ast_memory.hpp"
+#include "vb6_batch.hpp"
 #include "vb6_parser.hpp" // only for vb6_grammar::getParserInfo()
+#include "vb6_parser_api.hpp"
+#include "vb6_supervisor.hpp"
+#include "vb6_trace.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <iterator>
 #include <map>
+#include <set>
+#include <string>
 #include <string_view>
+#include <vector>
 
 void vb6_test1(std::ostream&);
 void vb6_test2(std::ostream&);
@@ -22,14 +34,14 @@ void test_gosub(std::ostream&);
 
 using namespace std;
 
-void test_vbasic(ostream& os, string const& fname)
+string read_unit(string const& fname)
 {
   ifstream is(fname, ios::binary);
 
   if(!is)
   {
     cerr << "Could not open input file: " << fname << '\n';
-    return;
+    return {};
   }
 
   // no whitespace skipping on the stream
@@ -38,8 +50,38 @@ void test_vbasic(ostream& os, string const& fname)
   string unit;
   copy(istream_iterator<char>(is), istream_iterator<char>(),
        back_inserter(unit));
+  return unit;
+}
 
-  test_vb6_unit(os, unit);
+void test_vbasic(ostream& os, string const& fname)
+{
+  vb6_grammar::trace_scope trace("file", "driver", fname);
+
+  string unit;
+  {
+    vb6_grammar::trace_scope load("load", "io", fname);
+    unit = read_unit(fname);
+  }
+  if(!unit.empty())
+    test_vb6_unit(os, unit);
+}
+
+void report_memory(ostream& os, string const& fname)
+{
+  auto const unit = read_unit(fname);
+  if(unit.empty())
+    return;
+
+  vb6_grammar::unit_memory_report report;
+  vb6_ast::vb_module ast;
+  {
+    vb6_grammar::alloc_scope scope;
+    vb6_grammar::phrase_parse_module(unit, ast);
+    report.parse = scope.delta();
+  }
+  report.ast = vb6_grammar::measure_module(ast);
+
+  vb6_grammar::print_memory_report(os, fname, report);
 }
 
 void test_vbasic(ostream& os)
@@ -53,17 +95,231 @@ Sub foo(a As Integer, b As Long)
   test_vb6_unit(os, unit);
 }
 
-int main()
+// the samples that used to be all this program did
+void self_test(ostream& os)
+{
+  os << vb6_grammar::getParserInfo() << '\n';
+
+  vb6_test1(os);
+  vb6_test_statements(os);
+  vb6_test2(os);
+
+  test_vbasic(os, "data/test.bas");
+  test_vbasic(os, "data/long_source.bas");
+  test_vbasic(os);
+
+  report_memory(os, "data/test.bas");
+  report_memory(os, "data/long_source.bas");
+
+  //test_gosub(os);
+}
+
+void usage(ostream& os, char const* program)
+{
+  os << "Usage: " << program << " [options] <file|directory|wildcard|project.vbp|archive.vb6pack|->...\n"
+        "       " << program << " --self-test\n"
+        "Options:\n"
+        "  --jobs N             parse with N threads (default 1)\n"
+        "  --read-ahead N       files being read at once (default 32)\n"
+        "  --no-io-uring        read the files with a pool of threads even where io_uring is available\n"
+        "  --no-dedup           parse again the files with the same contents as an earlier one\n"
+        "  --piece-bytes N      parse files of 2N bytes or more in pieces of about N bytes (default 262144, 0 never)\n"
+        "  --processes N        parse in N worker processes, replaced when they crash or time out\n"
+        "  --timeout MS         with --processes, time allowed to a file before its worker gets killed\n"
+        "  --quarantine DIR     with --processes, where to copy the files that crashed or timed out\n"
+        "  --format F           output of every parsed file: none (default), vb, cpp, raw, json, binary\n"
+        "  --stats              per-file and aggregate throughput, latency and failures on stderr\n"
+        "  --trace FILE         timeline of the run in the Chrome trace event format\n"
+        "  --perf-counters      hardware counters of loading, parsing and printing every file\n"
+        "A - argument reads a unit from stdin, parsed as it comes without holding all of it.\n"
+        "The exit code is 1 when a file could not be read or parsed.\n";
+}
+
+int main(int argc, char* argv[])
 {
-  cout << vb6_grammar::getParserInfo() << '\n';
+  vb6_grammar::batch_options options;
+  vb6_grammar::supervisor_options supervision;
+  vector<string> args;
+  string trace_file;
+  bool stats = false;
+  bool supervised = false;
+  bool run_self_test = false;
+
+  for(int i = 1; i < argc; ++i)
+  {
+    string_view const arg = argv[i];
+    bool const has_value = i + 1 < argc;
+
+    if(arg == "--jobs" && has_value)
+      options.jobs = static_cast<unsigned>(max(1, atoi(argv[++i])));
+    else if(arg == "--read-ahead" && has_value)
+      options.read_ahead = static_cast<size_t>(max(1, atoi(argv[++i])));
+    else if(arg == "--no-io-uring")
+      options.use_io_uring = false;
+    else if(arg == "--no-dedup")
+      options.deduplicate = false;
+    else if(arg == "--piece-bytes" && has_value)
+      options.piece_bytes = static_cast<size_t>(max(0, atoi(argv[++i])));
+    else if(arg == "--processes" && has_value)
+    {
+      supervision.processes = static_cast<unsigned>(max(1, atoi(argv[++i])));
+      supervised = true;
+    }
+    else if(arg == "--timeout" && has_value)
+      supervision.file_timeout = chrono::milliseconds(max(0, atoi(argv[++i])));
+    else if(arg == "--quarantine" && has_value)
+      supervision.quarantine_dir = argv[++i];
+    else if(arg == "--format" && has_value)
+    {
+      auto const format = vb6_grammar::parse_output_format(argv[++i]);
+      if(!format)
+      {
+        cerr << "Unknown format: " << argv[i] << '\n';
+        return 2;
+      }
+      options.format = *format;
+    }
+    else if(arg == "--stats")
+      stats = true;
+    else if(arg == "--trace" && has_value)
+      trace_file = argv[++i];
+    else if(arg == "--perf-counters")
+      options.perf_counters = true;
+    else if(arg == "--self-test")
+      run_self_test = true;
+    else if(arg == "--help" || arg == "-h")
+    {
+      usage(cout, argv[0]);
+      return 0;
+    }
+    else if(arg.starts_with("--"))
+    {
+      usage(cerr, argv[0]);
+      return 2;
+    }
+    else
+      args.emplace_back(arg);
+  }
+
+  if(!run_self_test && args.empty())
+  {
+    usage(cerr, argv[0]);
+    return 2;
+  }
+
+  if(!trace_file.empty())
+    vb6_grammar::start_trace(trace_file);
 
-  vb6_test1(cout);
-  vb6_test_statements(cout);
-  vb6_test2(cout);
+  int exit_code = 0;
+  if(run_self_test)
+    self_test(cout);
 
-  test_vbasic(cout, "data/test.bas");
-  test_vbasic(cout, "data/long_source.bas");
-  test_vbasic(cout);
+  if(!args.empty())
+  {
+    // archives are parsed from their mapping, by threads, the worker
+    // processes only get the files by their path
+    auto const is_archive = [](string const& arg) { return arg.ends_with(vb6_grammar::archive_extension); };
+    if(auto const a = find_if(args.begin(), args.end(), is_archive); supervised && a != args.end())
+    {
+      cerr << "--processes does not parse archives, parse " << *a << " without it\n";
+      return 2;
+    }
+
+    auto const print = [](vb6_grammar::file_result const& f) {
+      cout << f.output;
+      cerr << f.errors;
+    };
+
+    vb6_grammar::supervised_report report;
+    auto const add = [&](vb6_grammar::batch_report& part) {
+      move(part.files.begin(), part.files.end(), back_inserter(report.files));
+      report.wall_ns += part.wall_ns;
+      if(report.reader.empty())
+        report.reader = part.reader;
+    };
+
+    // The arguments are taken in order: an archive, stdin (parsed as it gets
+    // read, on this thread) or the files named up to the next one of those.
+    bool unreadable_archive = false;
+    set<filesystem::path> seen;
+    for(auto arg = args.begin(); arg != args.end();)
+    {
+      if(is_archive(*arg))
+      {
+        vb6_grammar::archive_view const view(*arg++);
+        if(!view.ok())
+        {
+          cerr << view.error() << '\n';
+          unreadable_archive = true;
+          continue;
+        }
+        auto part = vb6_grammar::run_batch(view, options, print);
+        add(part);
+      }
+      else if(*arg == "-")
+      {
+        ++arg;
+        auto& f = report.files.emplace_back(vb6_grammar::process_stream(cin, "<stdin>", options, cout));
+        cerr << f.errors;
+        report.wall_ns += f.latency_ns();
+        if(report.reader.empty())
+          report.reader = "stream";
+      }
+      else
+      {
+        auto const next = find_if(arg, args.end(), [&](string const& a) { return a == "-" || is_archive(a); });
+        auto inputs = vb6_grammar::collect_inputs({ arg, next }, cerr);
+        arg = next;
+        erase_if(inputs, [&](filesystem::path const& f) { return !seen.insert(f.lexically_normal()).second; });
+
+        if(supervised)
+        {
+          supervision.batch = options;
+          auto part = vb6_grammar::run_supervised(inputs, supervision, print);
+          move(part.shards.begin(), part.shards.end(), back_inserter(report.shards));
+          add(part);
+        }
+        else if(!inputs.empty())
+        {
+          auto part = vb6_grammar::run_batch(inputs, options, print);
+          add(part);
+        }
+      }
+    }
+    cout.flush();
+
+    if(stats)
+    {
+      vb6_grammar::print_batch_stats(cerr, report);
+      if(supervised)
+      {
+        cerr << '\n';
+        vb6_grammar::print_shard_stats(cerr, report);
+      }
+    }
 
-  //test_gosub(cout);
-}
\ No newline at end of file
+    if(options.perf_counters)
+    {
+      vb6_grammar::perf_counters probe;
+      if(!probe.available())
+        cerr << "Hardware counters not available: " << probe.error() << '\n';
+      else
+      {
+        vector<vb6_grammar::perf_file_report> perf;
+        for(auto& f : report.files)
+          perf.push_back(f.perf);
+        vb6_grammar::print_perf_report(cerr, perf);
+      }
+    }
+
+    if(report.files.empty() || unreadable_archive || report.failures() != 0)
+      exit_code = 1;
+  }
+
+  if(!trace_file.empty() && !vb6_grammar::stop_trace())
+  {
+    cerr << "Could not write the trace file: " << trace_file << '\n';
+    return 1;
+  }
+  return exit_code;
+}
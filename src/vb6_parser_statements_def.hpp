@@ -8,6 +8,10 @@
 
 #include "vb6_parser.hpp"
 #include "vb6_ast_adapt.hpp"
+#include "vb6_coverage.hpp"
+#include "vb6_parser_checkpoint.hpp"
+#include "vb6_parser_define.hpp"
+#include "vb6_parser_expect.hpp"
 #include "vb6_parser_keywords.hpp"
 #include "vb6_parser_operators.hpp"
 
@@ -50,9 +54,9 @@ namespace vb6_grammar {
   auto const cmdTermin = x3::eol | ':';
 
   // keyword groups
-  auto const kwgEndIf       = kwEnd > kwIf       > cmdTermin;
-  auto const kwgEndWith     = kwEnd > kwWith     > cmdTermin;
-  auto const kwgEndSelect   = kwEnd > kwSelect   > cmdTermin;
+  auto const kwgEndIf       = kwEnd >> expect("If")[kwIf]       >> expect("end of statement")[cmdTermin];
+  auto const kwgEndWith     = kwEnd >> expect("With")[kwWith]     >> expect("end of statement")[cmdTermin];
+  auto const kwgEndSelect   = kwEnd >> expect("Select")[kwSelect]   >> expect("end of statement")[cmdTermin];
 
   // statements
   namespace statements {
@@ -85,29 +89,29 @@ namespace vb6_grammar {
                               | withStmt
                               ;
 #else
-    auto const singleStmt1 = assignmentStmt
-                           | localvardeclStmt
-                           | redimStmt
-                           | exitStmt
-                           | gotoStmt
-                           | onerrorStmt
-                           | resumeStmt
-                           | labelStmt
-                           | callimplicitStmt
-                           | callexplicitStmt
-                           | raiseeventStmt
+    auto const singleStmt1 = cover("singleStmt1")[assignmentStmt]
+                           | cover("singleStmt1")[localvardeclStmt]
+                           | cover("singleStmt1")[redimStmt]
+                           | cover("singleStmt1")[exitStmt]
+                           | cover("singleStmt1")[gotoStmt]
+                           | cover("singleStmt1")[onerrorStmt]
+                           | cover("singleStmt1")[resumeStmt]
+                           | cover("singleStmt1")[labelStmt]
+                           | cover("singleStmt1")[callimplicitStmt]
+                           | cover("singleStmt1")[callexplicitStmt]
+                           | cover("singleStmt1")[raiseeventStmt]
                            ;
-    auto const singleStmt2 = whileStmt
-                           | doStmt
-                           | dowhileStmt
-                           | loopwhileStmt
-                           | dountilStmt
-                           | loopuntilStmt
-                           | forStmt
-                           | foreachStmt
-                           | ifelseStmt
-                           | selectStmt
-                           | withStmt
+    auto const singleStmt2 = cover("singleStmt2")[whileStmt]
+                           | cover("singleStmt2")[doStmt]
+                           | cover("singleStmt2")[dowhileStmt]
+                           | cover("singleStmt2")[loopwhileStmt]
+                           | cover("singleStmt2")[dountilStmt]
+                           | cover("singleStmt2")[loopuntilStmt]
+                           | cover("singleStmt2")[forStmt]
+                           | cover("singleStmt2")[foreachStmt]
+                           | cover("singleStmt2")[ifelseStmt]
+                           | cover("singleStmt2")[selectStmt]
+                           | cover("singleStmt2")[withStmt]
                            ;
     auto const singleStmt_def = lonely_comment // critical to have this as the first element
                               | empty_line
@@ -115,7 +119,7 @@ namespace vb6_grammar {
                               | singleStmt2;
 #endif
 
-    auto const statement_block_def = *singleStmt;
+    auto const statement_block_def = *(checkpoint >> singleStmt);
 
     auto const assignmentStmt_def = ( (kwSet   >> x3::attr(vb6_ast::assignmentType::set))
                                     | (kwLet   >> x3::attr(vb6_ast::assignmentType::let))
@@ -131,39 +135,40 @@ namespace vb6_grammar {
     // TODO redim statements must be able to act on several variables
     auto const redimStmt_def = kwReDim >> -(kwPreserve >> x3::attr(true))
                             //>> ((decorated_variable > '(' > (expression % ',') > ')') % ',')
-                            >> (decorated_variable > '(' > (expression % ',') > ')')
+                            >> (decorated_variable >> expect("'('")['('] >> expect("expression")[expression % ','] >> expect("')'")[')'])
                             >> cmdTermin;
 
-    auto const exitStmt_def = kwExit > ( kwSub      >> x3::attr(vb6_ast::exit_type::sub)
-                                       | kwFunction >> x3::attr(vb6_ast::exit_type::function)
-                                       | kwProperty >> x3::attr(vb6_ast::exit_type::property)
-                                       | kwDo       >> x3::attr(vb6_ast::exit_type::do_)
-                                       | kwWhile    >> x3::attr(vb6_ast::exit_type::while_)
-                                       | kwFor      >> x3::attr(vb6_ast::exit_type::for_)
-                                       )
-                           >> cmdTermin;
+    auto const exitStmt_def = kwExit >> expect("Sub, Function, Property, Do, While or For")
+                                            [ kwSub      >> x3::attr(vb6_ast::exit_type::sub)
+                                            | kwFunction >> x3::attr(vb6_ast::exit_type::function)
+                                            | kwProperty >> x3::attr(vb6_ast::exit_type::property)
+                                            | kwDo       >> x3::attr(vb6_ast::exit_type::do_)
+                                            | kwWhile    >> x3::attr(vb6_ast::exit_type::while_)
+                                            | kwFor      >> x3::attr(vb6_ast::exit_type::for_)
+                                            ]
+                                     >> expect("end of statement")[cmdTermin];
 
     auto const gotoLabel = basic_identifier;
 
     auto const gotoStmt_def = ( (kwGoTo  >> x3::attr(vb6_ast::gotoType::goto_v))
                               | (kwGoSub >> x3::attr(vb6_ast::gotoType::gosub_v))
-                              ) > gotoLabel >> cmdTermin;
-
-    auto const onerrorStmt_def = (kwOn > kwError)
-                              >> ( (kwResume > kwNext >> x3::attr(std::string()) >> x3::attr(vb6_ast::onerror_type::resume_next))
-                                 | (kwGoTo >> ('0' >> x3::attr(std::string()) >> x3::attr(vb6_ast::onerror_type::goto_0)))
-                                 | (kwGoTo >> ("-1" >> x3::attr(std::string()) >> x3::attr(vb6_ast::onerror_type::goto_neg_1)))
-                                 | (kwGoTo >> (gotoLabel >> x3::attr(vb6_ast::onerror_type::goto_label)))
-                                 | (kwExit >> (kwSub >> x3::attr(std::string()) >> x3::attr(vb6_ast::onerror_type::exit_sub)))
-                                 | (kwExit >> (kwFunction >> x3::attr(std::string()) >> x3::attr(vb6_ast::onerror_type::exit_func)))
-                                 | (kwExit >> (kwProperty >> x3::attr(std::string()) >> x3::attr(vb6_ast::onerror_type::exit_property)))
+                              ) >> expect("label")[gotoLabel] >> expect("end of statement")[cmdTermin];
+
+    auto const onerrorStmt_def = (kwOn >> expect("Error")[kwError])
+                              >> ( cover("onerrorStmt", "Resume Next")[kwResume >> expect("Next")[kwNext >> x3::attr(std::string()) >> x3::attr(vb6_ast::onerror_type::resume_next)]]
+                                 | cover("onerrorStmt", "GoTo 0")[kwGoTo >> ('0' >> x3::attr(std::string()) >> x3::attr(vb6_ast::onerror_type::goto_0))]
+                                 | cover("onerrorStmt", "GoTo -1")[kwGoTo >> ("-1" >> x3::attr(std::string()) >> x3::attr(vb6_ast::onerror_type::goto_neg_1))]
+                                 | cover("onerrorStmt", "GoTo label")[kwGoTo >> (gotoLabel >> x3::attr(vb6_ast::onerror_type::goto_label))]
+                                 | cover("onerrorStmt", "Exit Sub")[kwExit >> (kwSub >> x3::attr(std::string()) >> x3::attr(vb6_ast::onerror_type::exit_sub))]
+                                 | cover("onerrorStmt", "Exit Function")[kwExit >> (kwFunction >> x3::attr(std::string()) >> x3::attr(vb6_ast::onerror_type::exit_func))]
+                                 | cover("onerrorStmt", "Exit Property")[kwExit >> (kwProperty >> x3::attr(std::string()) >> x3::attr(vb6_ast::onerror_type::exit_property))]
                                  ) >> cmdTermin;
 
     auto const resumeStmt_def = kwResume
-                             >> ( (kwNext    >> x3::attr(0) >> x3::attr(vb6_ast::resume_type::next))
-                                | (             gotoLabel   >> x3::attr(vb6_ast::resume_type::label))
-                                | (             x3::int_    >> x3::attr(vb6_ast::resume_type::line_nr))
-                                | (x3::eps   >> x3::attr(0) >> x3::attr(vb6_ast::resume_type::implicit))
+                             >> ( cover("resumeStmt", "Next")[kwNext >> x3::attr(0) >> x3::attr(vb6_ast::resume_type::next)]
+                                | cover("resumeStmt", "label")[gotoLabel >> x3::attr(vb6_ast::resume_type::label)]
+                                | cover("resumeStmt", "line number")[x3::int_ >> x3::attr(vb6_ast::resume_type::line_nr)]
+                                | cover("resumeStmt", "implicit")[x3::eps >> x3::attr(0) >> x3::attr(vb6_ast::resume_type::implicit)]
                                 )
                              >> cmdTermin;
 
@@ -291,20 +296,20 @@ namespace vb6_grammar {
                               >> statement_block;
 
     // TODO select-statement
-    auto const selectStmt_def = (kwSelect > kwCase)
+    auto const selectStmt_def = (kwSelect >> expect("Case")[kwCase])
                              >> expression >> cmdTermin
                              >> (*case_block)
                              >> kwgEndSelect;
   } // namespace statements
 
-  BOOST_SPIRIT_DEFINE(
+  VB6_SPIRIT_DEFINE(
       statements::ifBranch
     , statements::elsifBranch
     , statements::elseBranch
     , statements::case_block
   )
 
-  BOOST_SPIRIT_DEFINE(
+  VB6_SPIRIT_DEFINE(
       statements::singleStmt
     , statements::statement_block
     , statements::assignmentStmt
@@ -321,7 +326,7 @@ namespace vb6_grammar {
   )
 
   // compound statements
-  BOOST_SPIRIT_DEFINE(
+  VB6_SPIRIT_DEFINE(
       statements::whileStmt
     , statements::doStmt
     , statements::dowhileStmt
@@ -0,0 +1,168 @@
+//: vb6_perf_counters.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_perf_counters.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace vb6_grammar {
+
+#ifdef __linux__
+
+namespace {
+
+int open_counter(std::uint32_t type, std::uint64_t config, int group_fd)
+{
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = group_fd == -1; // the group follows its leader
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0 /*this thread*/, -1 /*any cpu*/, group_fd, 0));
+}
+
+}
+
+perf_counters::perf_counters()
+{
+  struct
+  {
+    std::uint32_t type;
+    std::uint64_t config;
+  } const events[] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+  };
+
+  for(auto& ev : events)
+  {
+    int const fd = open_counter(ev.type, ev.config, fds.empty() ? -1 : fds.front());
+    if(fd < 0)
+    {
+      reason = std::string("perf_event_open: ") + std::strerror(errno);
+      for(int f : fds)
+        close(f);
+      fds.clear();
+      return;
+    }
+    fds.push_back(fd);
+  }
+  leader = fds.front();
+}
+
+perf_counters::~perf_counters()
+{
+  for(int fd : fds)
+    close(fd);
+}
+
+void perf_counters::start()
+{
+  if(leader < 0)
+    return;
+  ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+perf_sample perf_counters::stop()
+{
+  perf_sample sample;
+  if(leader < 0)
+    return sample;
+  ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+  // with PERF_FORMAT_GROUP: the number of counters, then their values
+  std::uint64_t values[1 + 4] = {};
+  if(read(leader, values, sizeof(values)) < static_cast<ssize_t>(sizeof(std::uint64_t) * (1 + fds.size())))
+    return sample;
+
+  sample.cycles = values[1];
+  sample.instructions = values[2];
+  sample.branch_misses = values[3];
+  sample.cache_misses = values[4];
+  return sample;
+}
+
+#else
+
+perf_counters::perf_counters()
+  : reason("hardware counters are only supported on Linux")
+{
+}
+
+perf_counters::~perf_counters() = default;
+
+void perf_counters::start() {}
+
+perf_sample perf_counters::stop()
+{
+  return {};
+}
+
+#endif
+
+namespace {
+
+void print_line(std::ostream& os, std::string_view name, char const* phase, perf_sample const& s)
+{
+  os << std::left << std::setw(32) << name << std::setw(7) << phase << std::right
+     << std::setw(14) << s.cycles
+     << std::setw(14) << s.instructions
+     << std::setw(7) << std::fixed << std::setprecision(2) << s.ipc()
+     << std::setw(14) << s.branch_misses
+     << std::setw(14) << s.cache_misses << '\n';
+}
+
+}
+
+void print_perf_report(std::ostream& os, std::vector<perf_file_report> const& files)
+{
+  os << std::left << std::setw(32) << "file" << std::setw(7) << "phase" << std::right
+     << std::setw(14) << "cycles"
+     << std::setw(14) << "instructions"
+     << std::setw(7) << "IPC"
+     << std::setw(14) << "branch-misses"
+     << std::setw(14) << "cache-misses" << '\n';
+
+  perf_file_report total;
+  for(auto& f : files)
+  {
+    print_line(os, f.name, "load", f.load);
+    print_line(os, f.name, "parse", f.parse);
+    print_line(os, f.name, "print", f.print);
+    total.load += f.load;
+    total.parse += f.parse;
+    total.print += f.print;
+  }
+
+  perf_sample all = total.load;
+  all += total.parse;
+  all += total.print;
+
+  print_line(os, "total", "load", total.load);
+  print_line(os, "total", "parse", total.parse);
+  print_line(os, "total", "print", total.print);
+  print_line(os, "total", "all", all);
+}
+
+}
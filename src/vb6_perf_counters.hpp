@@ -0,0 +1,97 @@
+//: vb6_perf_counters.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vb6_grammar {
+
+  // hardware events counted in user space by the calling thread
+  struct perf_sample
+  {
+    std::uint64_t cycles = 0;
+    std::uint64_t instructions = 0;
+    std::uint64_t branch_misses = 0;
+    std::uint64_t cache_misses = 0;
+
+    double ipc() const { return cycles ? static_cast<double>(instructions) / static_cast<double>(cycles) : 0.0; }
+
+    perf_sample& operator+=(perf_sample const& rhs)
+    {
+      cycles += rhs.cycles;
+      instructions += rhs.instructions;
+      branch_misses += rhs.branch_misses;
+      cache_misses += rhs.cache_misses;
+      return *this;
+    }
+  };
+
+  // A group of counters opened with perf_event_open, on Linux only.
+  // When the kernel does not allow it (see /proc/sys/kernel/perf_event_paranoid)
+  // available() is false, error() tells why, and every sample is zero.
+  class perf_counters
+  {
+  public:
+    perf_counters();
+    ~perf_counters();
+
+    perf_counters(perf_counters const&) = delete;
+    perf_counters& operator=(perf_counters const&) = delete;
+
+    bool available() const { return leader >= 0; }
+    std::string const& error() const { return reason; }
+
+    void start();
+    perf_sample stop();
+
+  private:
+    int leader = -1;
+    std::vector<int> fds; // leader first, in the order of perf_sample
+    std::string reason;
+  };
+
+  // counters of a phase, taken from construction to stop() or destruction
+  class perf_scope
+  {
+  public:
+    perf_scope(perf_counters& counters, perf_sample& into)
+      : counters(counters), into(into)
+    {
+      counters.start();
+    }
+
+    ~perf_scope() { stop(); }
+
+    void stop()
+    {
+      if(!stopped)
+        into += counters.stop();
+      stopped = true;
+    }
+
+  private:
+    perf_counters& counters;
+    perf_sample& into;
+    bool stopped = false;
+  };
+
+  // what every phase of the processing of a file cost
+  struct perf_file_report
+  {
+    std::string name;
+    perf_sample load;
+    perf_sample parse;
+    perf_sample print;
+  };
+
+  // a table with one line per file and phase, then the totals of every phase
+  void print_perf_report(std::ostream& os, std::vector<perf_file_report> const& files);
+}
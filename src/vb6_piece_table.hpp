@@ -0,0 +1,199 @@
+//: vb6_piece_table.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vb6_grammar {
+
+  class piece_text;
+
+  // Random access, but not contiguous: stepping within a piece is as cheap
+  // as with a pointer, jumping looks the piece up with a binary search.
+  class piece_iterator
+  {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = char;
+    using difference_type = std::ptrdiff_t;
+    using pointer = char const*;
+    using reference = char const&;
+
+    piece_iterator() = default;
+
+    reference operator*() const { return *p; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    piece_iterator& operator++()
+    {
+      if(++p == piece_end)
+        enter(piece + 1);
+      return *this;
+    }
+
+    piece_iterator operator++(int)
+    {
+      auto old = *this;
+      ++*this;
+      return old;
+    }
+
+    piece_iterator& operator--()
+    {
+      if(!p || p == piece_begin())
+      {
+        enter(piece - 1);
+        p = piece_end;
+      }
+      --p;
+      return *this;
+    }
+
+    piece_iterator operator--(int)
+    {
+      auto old = *this;
+      --*this;
+      return old;
+    }
+
+    piece_iterator& operator+=(difference_type n);
+    piece_iterator& operator-=(difference_type n) { return *this += -n; }
+
+    friend piece_iterator operator+(piece_iterator it, difference_type n) { return it += n; }
+    friend piece_iterator operator+(difference_type n, piece_iterator it) { return it += n; }
+    friend piece_iterator operator-(piece_iterator it, difference_type n) { return it -= n; }
+
+    friend difference_type operator-(piece_iterator const& a, piece_iterator const& b)
+    {
+      return static_cast<difference_type>(a.offset()) - static_cast<difference_type>(b.offset());
+    }
+
+    // pieces are never empty, so an iterator is never at the end of one
+    // unless it is the end of the text
+    friend bool operator==(piece_iterator const& a, piece_iterator const& b) { return a.p == b.p; }
+    friend std::strong_ordering operator<=>(piece_iterator const& a, piece_iterator const& b)
+    {
+      return a.offset() <=> b.offset();
+    }
+
+    // from the beginning of the text
+    std::size_t offset() const;
+
+  private:
+    friend class piece_text;
+
+    piece_iterator(piece_text const* text, std::size_t piece) : text(text) { enter(piece); }
+
+    void enter(std::size_t index);
+    char const* piece_begin() const;
+
+    piece_text const* text = nullptr;
+    std::size_t piece = 0;
+    char const* p = nullptr; // null at the end of the text
+    char const* piece_end = nullptr;
+  };
+
+  // Text made of pieces that live elsewhere, as an editor keeps a buffer
+  // being edited (the pieces of a piece table, the leaves of a rope), so
+  // that it can be parsed without being copied into one string first.
+  class piece_text
+  {
+  public:
+    piece_text() = default;
+
+    explicit piece_text(std::vector<std::string_view> const& pieces)
+    {
+      for(auto piece : pieces)
+        append(piece);
+    }
+
+    // the piece must outlive the text, empty ones are left out
+    void append(std::string_view piece)
+    {
+      if(piece.empty())
+        return;
+      pieces.push_back(piece);
+      starts.push_back(total);
+      total += piece.size();
+    }
+
+    std::size_t size() const { return total; }
+    std::size_t piece_count() const { return pieces.size(); }
+
+    piece_iterator begin() const { return { this, 0 }; }
+    piece_iterator end() const { return { this, pieces.size() }; }
+
+    // a copy in one string
+    std::string str() const
+    {
+      std::string s;
+      s.reserve(total);
+      for(auto piece : pieces)
+        s.append(piece);
+      return s;
+    }
+
+  private:
+    friend class piece_iterator;
+
+    std::vector<std::string_view> pieces;
+    std::vector<std::size_t> starts; // offset of every piece in the text
+    std::size_t total = 0;
+  };
+
+  inline void piece_iterator::enter(std::size_t index)
+  {
+    piece = index;
+    if(index < text->pieces.size())
+    {
+      p = text->pieces[index].data();
+      piece_end = p + text->pieces[index].size();
+    }
+    else
+      p = piece_end = nullptr;
+  }
+
+  inline char const* piece_iterator::piece_begin() const
+  {
+    return piece < text->pieces.size() ? text->pieces[piece].data() : nullptr;
+  }
+
+  inline std::size_t piece_iterator::offset() const
+  {
+    if(!p)
+      return text ? text->total : 0;
+    return text->starts[piece] + static_cast<std::size_t>(p - piece_begin());
+  }
+
+  inline piece_iterator& piece_iterator::operator+=(difference_type n)
+  {
+    // within the piece
+    if(p && (n >= 0 ? n < piece_end - p : -n <= p - piece_begin()))
+    {
+      p += n;
+      return *this;
+    }
+
+    auto const target = static_cast<std::size_t>(static_cast<difference_type>(offset()) + n);
+    if(target >= text->total)
+    {
+      enter(text->pieces.size());
+      return *this;
+    }
+    auto const it = std::upper_bound(text->starts.begin(), text->starts.end(), target);
+    enter(static_cast<std::size_t>(it - text->starts.begin()) - 1);
+    p += target - text->starts[piece];
+    return *this;
+  }
+}
@@ -0,0 +1,26 @@
+//: vb6_probes.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_probes.hpp"
+
+#ifdef VB6_USDT
+
+// the semaphores must live in the .probes section for the tracers to find them
+#define VB6_PROBE_SEMAPHORE_DEF(name) \
+  volatile unsigned short vb6_parser_##name##_semaphore __attribute__((section(".probes"))) = 0
+
+extern "C" {
+
+VB6_PROBE_SEMAPHORE_DEF(file__start);
+VB6_PROBE_SEMAPHORE_DEF(file__done);
+VB6_PROBE_SEMAPHORE_DEF(parse__start);
+VB6_PROBE_SEMAPHORE_DEF(parse__done);
+VB6_PROBE_SEMAPHORE_DEF(item__done);
+VB6_PROBE_SEMAPHORE_DEF(expectation__failed);
+
+}
+
+#endif
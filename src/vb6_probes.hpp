@@ -0,0 +1,49 @@
+//: vb6_probes.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+// Static tracepoints (USDT) for perf, bpftrace and systemtap, in provider
+// vb6_parser:
+//
+//   file__start(char const* file, size_t bytes)
+//   file__done(char const* file, size_t bytes, uint64_t ns, int ok)
+//   parse__start(char const* rule, size_t bytes)
+//   parse__done(char const* rule, size_t consumed, int status, uint64_t ns)
+//   item__done(char const* kind, size_t begin, size_t end, uint64_t ns)
+//   expectation__failed(size_t offset, char const* which)
+//
+// An unattached probe is a nop instruction, the arguments that take some
+// work (the durations) are only computed while a tracer is attached.
+// Without <sys/sdt.h>, or with VB6_NO_USDT defined, they compile to nothing.
+
+#pragma once
+
+#if !defined(VB6_NO_USDT) && defined(__linux__) && __has_include(<sys/sdt.h>)
+#define VB6_USDT
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+#endif
+
+#ifdef VB6_USDT
+
+// set by the tracer attaching to the probe, see vb6_probes.cpp
+#define VB6_PROBE_SEMAPHORE(name) extern "C" volatile unsigned short vb6_parser_##name##_semaphore
+
+VB6_PROBE_SEMAPHORE(file__start);
+VB6_PROBE_SEMAPHORE(file__done);
+VB6_PROBE_SEMAPHORE(parse__start);
+VB6_PROBE_SEMAPHORE(parse__done);
+VB6_PROBE_SEMAPHORE(item__done);
+VB6_PROBE_SEMAPHORE(expectation__failed);
+
+#define VB6_PROBE_ENABLED(name) __builtin_expect(vb6_parser_##name##_semaphore != 0, 0)
+#define VB6_PROBE(name, ...) STAP_PROBEV(vb6_parser, name, __VA_ARGS__)
+
+#else
+
+#define VB6_PROBE_ENABLED(name) false
+#define VB6_PROBE(name, ...) ((void)0)
+
+#endif
@@ -0,0 +1,85 @@
+//: vb6_span_table.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <boost/spirit/home/x3.hpp>
+#include <boost/spirit/home/x3/support/ast/position_tagged.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace vb6_grammar {
+
+  namespace x3 = boost::spirit::x3;
+
+  // offsets from the beginning of the parsed buffer
+  struct source_span
+  {
+    std::uint32_t begin = 0;
+    std::uint32_t end = 0;
+  };
+
+  // Location of the AST nodes, kept aside from the AST.
+  // A node tagged here has id_first == id_last == index of its span, which
+  // takes 8 bytes instead of the pair of iterators of x3::position_cache.
+  class span_table
+  {
+  public:
+    void tag(x3::position_tagged& ast, std::size_t begin, std::size_t end)
+    {
+      ast.id_first = ast.id_last = static_cast<int>(spans.size());
+      spans.push_back({ static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(end) });
+    }
+
+    // empty span for the nodes that have not been tagged
+    source_span span_of(x3::position_tagged const& ast) const
+    {
+      if(ast.id_first < 0 || static_cast<std::size_t>(ast.id_first) >= spans.size())
+        return {};
+      return spans[static_cast<std::size_t>(ast.id_first)];
+    }
+
+    std::size_t size() const { return spans.size(); }
+    std::size_t memory_usage() const { return spans.capacity() * sizeof(source_span); }
+
+    void reserve(std::size_t n) { spans.reserve(n); }
+    void clear() { spans.clear(); }
+
+  private:
+    std::vector<source_span> spans;
+  };
+
+  struct vb6_error_handler_tag;
+
+  // Base of the rule IDs whose attribute gets a span, it is the counterpart
+  // of x3::annotate_on_success. Nothing gets recorded unless the error
+  // handler has been given a span_table.
+  // A rule that matched also drops the diagnostics of the expectations that
+  // failed inside its match, they were in branches given up for one that parsed.
+  struct annotate_span
+  {
+    template <typename Iterator, typename Attribute, typename Context>
+    void on_success(Iterator const& first, Iterator const& last, Attribute& ast, Context const& context) const
+    {
+      auto& handler = x3::get<vb6_error_handler_tag>(context);
+      if constexpr(!std::is_same_v<std::decay_t<decltype(handler)>, x3::unused_type>)
+      {
+        auto& error_handler = handler.get();
+        if(!error_handler.diagnostics().empty())
+          error_handler.recovered(first, last);
+
+        if constexpr(std::is_base_of_v<x3::position_tagged, Attribute>)
+        {
+          if(auto* table = error_handler.spans())
+            table->tag(ast, error_handler.offset_of(first), error_handler.offset_of(last));
+        }
+      }
+    }
+  };
+}
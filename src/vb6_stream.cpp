@@ -0,0 +1,119 @@
+//: vb6_stream.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_stream.hpp"
+#include "vb6_line_index.hpp"
+#include "vb6_outline.hpp"
+#include "vb6_parser_api.hpp"
+
+#include <algorithm>
+#include <istream>
+
+namespace vb6_grammar {
+
+chunked_source::chunked_source(std::istream& in, std::size_t chunk_bytes)
+  : in(in), chunk(std::max<std::size_t>(chunk_bytes, 1))
+{
+}
+
+bool chunked_source::fill()
+{
+  if(eof)
+    return false;
+
+  auto const size = buffer.size();
+  buffer.resize(size + chunk);
+  in.read(buffer.data() + size, static_cast<std::streamsize>(chunk));
+  auto const got = static_cast<std::size_t>(in.gcount());
+  buffer.resize(size + got);
+  peak = std::max(peak, buffer.size());
+  if(got < chunk)
+    eof = true;
+  return got > 0;
+}
+
+void chunked_source::consume(std::size_t n)
+{
+  n = std::min(n, buffer.size() - first);
+  first += n;
+  consumed += n;
+
+  // moving what is left to the front once it is at most half of the buffer
+  // keeps it from growing and costs a constant per byte read
+  if(first >= buffer.size() - first)
+  {
+    buffer.erase(0, first);
+    first = 0;
+  }
+}
+
+stream_parse_result parse_module_stream(std::istream& in, module_items_sink const& on_items, std::size_t chunk_bytes)
+{
+  chunked_source source{ in, chunk_bytes };
+  parse_session session;
+  stream_parse_result result;
+
+  // sniffed from complete lines, a partial one could be anything
+  unit_layout layout;
+  for(;;)
+  {
+    auto const window = source.window();
+    auto const lines_end = source.at_end() ? window.size() : window.rfind('\n') + 1;
+    layout = sniff_unit(window.substr(0, lines_end));
+    if(layout.header_ended || source.at_end())
+      break;
+    source.fill();
+  }
+  result.kind = layout.kind;
+  source.consume(layout.code_begin);
+  result.consumed = source.offset();
+  std::size_t lines = layout.code_line; // before the window
+
+  for(;;)
+  {
+    auto const window = source.window();
+    auto const cut = source.at_end() ? window.size() : complete_items_end(window);
+    if(cut == 0)
+    {
+      if(source.at_end())
+        break;
+      source.fill();
+      continue;
+    }
+
+    auto const part = window.substr(0, cut);
+    auto const& r = session.parse_module(part);
+    auto& items = session.module();
+
+    // the window starts at the beginning of a line, so only the line moves
+    for(auto d : r.diagnostics)
+    {
+      d.offset += source.offset();
+      d.where.line += lines;
+      result.diagnostics.push_back(std::move(d));
+    }
+    if(!items.empty())
+    {
+      result.items += items.size();
+      on_items(items);
+    }
+    if(r.status != parse_status::ok)
+    {
+      result.status = r.status;
+      result.consumed = source.offset() + r.consumed;
+      break;
+    }
+
+    lines += count_newlines(part);
+    source.consume(cut);
+    result.consumed = source.offset();
+  }
+
+  result.peak_bytes = source.peak_bytes();
+  return result;
+}
+
+}
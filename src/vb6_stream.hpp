@@ -0,0 +1,77 @@
+//: vb6_stream.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include "vb6_ast.hpp"
+#include "vb6_error_handler.hpp"
+#include "vb6_unit.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vb6_grammar {
+
+  // The text of a stream read a chunk at a time, of which only what has not
+  // been consumed yet stays in memory.
+  class chunked_source
+  {
+  public:
+    explicit chunked_source(std::istream& in, std::size_t chunk_bytes = 64 * 1024);
+
+    // read and not consumed yet, valid until the next fill() or consume()
+    std::string_view window() const { return std::string_view(buffer).substr(first); }
+
+    // appends up to a chunk to the window, false at the end of the stream
+    bool fill();
+
+    bool at_end() const { return eof; }
+
+    // drops the first n bytes of the window
+    void consume(std::size_t n);
+
+    // of the beginning of the window, from the beginning of the stream
+    std::size_t offset() const { return consumed; }
+
+    // most bytes held at once
+    std::size_t peak_bytes() const { return peak; }
+
+  private:
+    std::istream& in;
+    std::size_t chunk;
+    std::string buffer;
+    std::size_t first = 0; // of the window in buffer
+    std::size_t consumed = 0;
+    std::size_t peak = 0;
+    bool eof = false;
+  };
+
+  struct stream_parse_result
+  {
+    parse_status status = parse_status::ok;
+    std::size_t consumed = 0;   // bytes of the stream covered by the items handed out
+    std::size_t items = 0;      // handed out
+    std::size_t peak_bytes = 0; // most of the stream held in memory at once
+    std::vector<vb6_diagnostic> diagnostics; // offsets and lines in the stream
+    unit_kind kind = unit_kind::module;      // see sniff_unit
+  };
+
+  // called with the items of the module as they get parsed, a batch at a time
+  using module_items_sink = std::function<void(vb6_ast::vb_module& items)>;
+
+  // Parses a module coming from a stream (stdin, a pipe) without reading all of
+  // it first: whenever the window holds complete top-level items (see
+  // complete_items_end) they get parsed, handed to on_items and forgotten. So
+  // the memory held is about a chunk plus the biggest item, not the unit.
+  // The header of a form or class, if the stream starts with one, is skipped
+  // first. Stops at the first item that does not parse.
+  stream_parse_result parse_module_stream(std::istream& in, module_items_sink const& on_items,
+                                          std::size_t chunk_bytes = 64 * 1024);
+}
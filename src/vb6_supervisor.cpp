@@ -0,0 +1,547 @@
+//: vb6_supervisor.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_supervisor.hpp"
+#include "vb6_trace.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define VB6_SUPERVISOR_FORK
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace vb6_grammar {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+#ifdef VB6_SUPERVISOR_FORK
+
+// gives the sink the files done that are next in the order of the inputs
+void hand_out(supervised_report& report, std::vector<char> const& done, std::size_t& next, batch_sink const& sink)
+{
+  for(; next < done.size() && done[next]; ++next)
+  {
+    if(sink)
+    {
+      auto& res = report.files[next];
+      sink(res);
+      std::string().swap(res.output);
+      std::string().swap(res.errors);
+    }
+  }
+}
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+constexpr auto idle = static_cast<std::size_t>(-1);
+
+// Worker and supervisor talk through a socket pair: the supervisor sends the
+// index of a file, the worker answers with its result. A message is its
+// length on 8 bytes followed by its content.
+
+bool write_all(int fd, char const* data, std::size_t size)
+{
+  while(size != 0)
+  {
+    auto const n = ::send(fd, data, size, MSG_NOSIGNAL); // a dead peer must not raise SIGPIPE
+    if(n < 0)
+    {
+      if(errno == EINTR)
+        continue;
+      return false;
+    }
+    data += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+bool read_all(int fd, char* data, std::size_t size)
+{
+  while(size != 0)
+  {
+    auto const n = ::read(fd, data, size);
+    if(n < 0)
+    {
+      if(errno == EINTR)
+        continue;
+      return false;
+    }
+    if(n == 0)
+      return false;
+    data += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+bool send_message(int fd, std::string const& payload)
+{
+  std::uint64_t const size = payload.size();
+  return write_all(fd, reinterpret_cast<char const*>(&size), sizeof(size))
+      && write_all(fd, payload.data(), payload.size());
+}
+
+bool receive_message(int fd, std::string& payload)
+{
+  std::uint64_t size = 0;
+  if(!read_all(fd, reinterpret_cast<char*>(&size), sizeof(size)))
+    return false;
+  payload.resize(static_cast<std::size_t>(size));
+  return read_all(fd, payload.data(), payload.size());
+}
+
+// The supervisor does not wait on a worker: it adds what has come so far to
+// the inbox of the worker, and takes a message out once complete, so that a
+// worker stalling in the middle of one still times out. False once the
+// connection is closed or broken.
+bool receive_some(int fd, std::string& inbox)
+{
+  char buffer[64 * 1024];
+  for(;;)
+  {
+    auto const n = ::recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if(n > 0)
+    {
+      inbox.append(buffer, static_cast<std::size_t>(n));
+      return true;
+    }
+    if(n == 0)
+      return false;
+    if(errno != EINTR)
+      return errno == EAGAIN || errno == EWOULDBLOCK;
+  }
+}
+
+bool take_message(std::string& inbox, std::string& payload)
+{
+  std::uint64_t size = 0;
+  if(inbox.size() < sizeof(size))
+    return false;
+  std::memcpy(&size, inbox.data(), sizeof(size));
+  if(inbox.size() - sizeof(size) < size)
+    return false;
+  payload.assign(inbox, sizeof(size), static_cast<std::size_t>(size));
+  inbox.erase(0, sizeof(size) + static_cast<std::size_t>(size));
+  return true;
+}
+
+struct message_writer
+{
+  std::string data;
+
+  void put(std::uint64_t value) { data.append(reinterpret_cast<char const*>(&value), sizeof(value)); }
+
+  void put(std::string_view str)
+  {
+    put(static_cast<std::uint64_t>(str.size()));
+    data.append(str);
+  }
+
+  void put(perf_sample const& s)
+  {
+    put(s.cycles);
+    put(s.instructions);
+    put(s.branch_misses);
+    put(s.cache_misses);
+  }
+};
+
+struct message_reader
+{
+  std::string_view data;
+
+  std::uint64_t get()
+  {
+    std::uint64_t value = 0;
+    if(data.size() >= sizeof(value))
+    {
+      std::memcpy(&value, data.data(), sizeof(value));
+      data.remove_prefix(sizeof(value));
+    }
+    return value;
+  }
+
+  std::string get_string()
+  {
+    auto const size = std::min<std::size_t>(static_cast<std::size_t>(get()), data.size());
+    std::string str(data.substr(0, size));
+    data.remove_prefix(size);
+    return str;
+  }
+
+  void get(perf_sample& s)
+  {
+    s.cycles = get();
+    s.instructions = get();
+    s.branch_misses = get();
+    s.cache_misses = get();
+  }
+};
+
+// the name is not sent, the supervisor knows it
+std::string encode(file_result const& res)
+{
+  message_writer out;
+  out.put(static_cast<std::uint64_t>(res.loaded));
+  out.put(res.bytes);
+  out.put(static_cast<std::uint64_t>(res.status));
+  out.put(res.load_ns);
+  out.put(res.parse_ns);
+  out.put(res.print_ns);
+  out.put(res.output);
+  out.put(res.errors);
+  out.put(res.perf.load);
+  out.put(res.perf.parse);
+  out.put(res.perf.print);
+  return std::move(out.data);
+}
+
+void decode(std::string_view data, file_result& res)
+{
+  message_reader in{ data };
+  res.loaded = in.get() != 0;
+  res.bytes = static_cast<std::size_t>(in.get());
+  res.status = static_cast<parse_status>(in.get());
+  res.load_ns = in.get();
+  res.parse_ns = in.get();
+  res.print_ns = in.get();
+  res.output = in.get_string();
+  res.errors = in.get_string();
+  in.get(res.perf.load);
+  in.get(res.perf.parse);
+  in.get(res.perf.print);
+}
+
+struct worker_process
+{
+  pid_t pid = -1;
+  int fd = -1;
+  std::size_t file = idle;  // being processed
+  std::uint64_t since = 0;  // when it was handed out
+  std::string inbox;        // what came of its answer so far
+};
+
+[[noreturn]] void worker_main(int fd, std::vector<fs::path> const& files, supervisor_options const& options)
+{
+  std::optional<perf_counters> counters;
+  if(options.batch.perf_counters)
+    counters.emplace();
+  perf_counters* c = counters && counters->available() ? &*counters : nullptr;
+
+  for(std::string msg; receive_message(fd, msg);)
+  {
+    auto const index = static_cast<std::size_t>(message_reader{ msg }.get());
+    if(index >= files.size())
+      break;
+    if(options.before_file)
+      options.before_file(files[index]);
+    if(!send_message(fd, encode(process_file(files[index], options.batch, c))))
+      break;
+  }
+  // what the parent had registered with atexit or buffered is not ours
+  ::_exit(0);
+}
+
+bool spawn(worker_process& w, std::vector<worker_process> const& all,
+           std::vector<fs::path> const& files, supervisor_options const& options)
+{
+  int fds[2];
+  if(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+    return false;
+
+  auto const pid = ::fork();
+  if(pid < 0)
+  {
+    ::close(fds[0]);
+    ::close(fds[1]);
+    return false;
+  }
+  if(pid == 0)
+  {
+    ::close(fds[0]);
+    for(auto& other : all)
+    {
+      if(other.fd >= 0)
+        ::close(other.fd);
+    }
+    worker_main(fds[1], files, options);
+  }
+
+  ::close(fds[1]);
+  w.pid = pid;
+  w.fd = fds[0];
+  w.file = idle;
+  w.inbox.clear();
+  return true;
+}
+
+// closes the connection and waits for the process to be gone
+int reap(worker_process& w, bool kill)
+{
+  if(kill)
+    ::kill(w.pid, SIGKILL);
+  ::close(w.fd);
+  int status = 0;
+  while(::waitpid(w.pid, &status, 0) < 0 && errno == EINTR)
+  {
+  }
+  w.pid = -1;
+  w.fd = -1;
+  w.file = idle;
+  return status;
+}
+
+std::string death_reason(int status)
+{
+  if(WIFSIGNALED(status))
+    return "crashed the worker (signal " + std::to_string(WTERMSIG(status)) + ')';
+  return "stopped the worker (exit code " + std::to_string(WEXITSTATUS(status)) + ')';
+}
+
+#endif
+
+}
+
+unsigned supervised_report::restarts() const
+{
+  unsigned total = 0;
+  for(auto& s : shards)
+    total += s.crashes + s.timeouts;
+  return total;
+}
+
+std::size_t supervised_report::quarantined() const
+{
+  return static_cast<std::size_t>(std::count_if(files.begin(), files.end(), [](auto& f) { return !f.quarantined.empty(); }));
+}
+
+#ifdef VB6_SUPERVISOR_FORK
+
+supervised_report run_supervised(std::vector<fs::path> const& files, supervisor_options const& options, batch_sink const& sink)
+{
+  supervised_report report;
+  report.files.resize(files.size());
+
+  auto const start = trace_clock();
+  auto const timeout_ns = static_cast<std::uint64_t>(std::chrono::nanoseconds(options.file_timeout).count());
+
+  auto const processes = std::max(1u, std::min<unsigned>(options.processes, static_cast<unsigned>(files.size())));
+  std::vector<worker_process> workers(processes);
+  report.shards.resize(processes);
+
+  std::vector<char> done(files.size());
+  std::size_t next_file = 0;
+  std::size_t next_out = 0;
+
+  auto finish = [&](std::size_t index, file_result res) {
+    res.name = files[index].string();
+    res.perf.name = res.name;
+    report.files[index] = std::move(res);
+    done[index] = true;
+    hand_out(report, done, next_out, sink);
+  };
+
+  auto dispatch = [&](worker_process& w) {
+    if(w.pid < 0 || next_file == files.size())
+      return;
+    message_writer msg;
+    msg.put(static_cast<std::uint64_t>(next_file));
+    if(send_message(w.fd, msg.data))
+    {
+      w.file = next_file++;
+      w.since = trace_clock();
+    }
+  };
+
+  // the file of a worker that died or hung, the worker gets replaced
+  auto quarantine = [&](std::size_t shard, std::size_t index, std::uint64_t busy, std::string const& reason) {
+    file_result res;
+    res.parse_ns = busy;
+    res.quarantined = reason;
+    res.errors = files[index].string() + ": " + reason + ", quarantined\n";
+    if(!options.quarantine_dir.empty())
+    {
+      // prefixed with the position of the file, two Module1.bas of different
+      // directories must not take the place of each other
+      auto const copy = options.quarantine_dir / (std::to_string(index) + '-' + files[index].filename().string());
+      std::error_code ec;
+      fs::create_directories(options.quarantine_dir, ec);
+      if(!ec)
+        fs::copy_file(files[index], copy, fs::copy_options::overwrite_existing, ec);
+      if(ec)
+        res.errors += files[index].string() + ": could not be copied to " + copy.string() + ": " + ec.message() + '\n';
+    }
+    report.shards[shard].files += 1;
+    report.shards[shard].busy_ns += busy;
+    finish(index, std::move(res));
+
+    auto& w = workers[shard];
+    if(spawn(w, workers, files, options))
+      dispatch(w);
+  };
+
+  for(auto& w : workers)
+  {
+    if(spawn(w, workers, files, options))
+      dispatch(w);
+  }
+
+  std::vector<pollfd> polled;
+  std::vector<std::size_t> shard_of;
+  for(;;)
+  {
+    polled.clear();
+    shard_of.clear();
+    int wait_ms = -1;
+    auto now = trace_clock();
+    for(std::size_t s = 0; s < workers.size(); ++s)
+    {
+      auto& w = workers[s];
+      if(w.file == idle)
+        continue;
+      polled.push_back({ w.fd, POLLIN, 0 });
+      shard_of.push_back(s);
+      if(timeout_ns != 0)
+      {
+        auto const left = w.since + timeout_ns > now ? w.since + timeout_ns - now : 0;
+        auto const ms = static_cast<int>(std::min<std::uint64_t>((left + 999'999) / 1'000'000, 60'000));
+        wait_ms = wait_ms < 0 ? ms : std::min(wait_ms, ms);
+      }
+    }
+    if(polled.empty())
+      break;
+
+    if(::poll(polled.data(), polled.size(), wait_ms) < 0 && errno != EINTR)
+      break;
+
+    now = trace_clock();
+    for(std::size_t p = 0; p < polled.size(); ++p)
+    {
+      auto const s = shard_of[p];
+      auto& w = workers[s];
+      if(polled[p].revents != 0)
+      {
+        std::string msg;
+        if(!receive_some(w.fd, w.inbox))
+        {
+          auto const index = w.file;
+          auto const busy = now - w.since;
+          auto const status = reap(w, true); // harmless if it is gone already
+          ++report.shards[s].crashes;
+          quarantine(s, index, busy, death_reason(status));
+          continue;
+        }
+        if(take_message(w.inbox, msg))
+        {
+          file_result res;
+          decode(msg, res);
+          auto& shard = report.shards[s];
+          shard.files += 1;
+          shard.bytes += res.bytes;
+          shard.busy_ns += trace_clock() - w.since;
+          auto const index = w.file;
+          w.file = idle;
+          finish(index, std::move(res));
+          dispatch(w);
+          continue;
+        }
+      }
+      // the deadline is for the whole answer, a part of it does not count
+      if(timeout_ns != 0 && now - w.since >= timeout_ns)
+      {
+        auto const index = w.file;
+        auto const busy = now - w.since;
+        reap(w, true);
+        ++report.shards[s].timeouts;
+        quarantine(s, index, busy, "timed out after " + std::to_string(options.file_timeout.count()) + " ms");
+      }
+    }
+  }
+
+  // left over when no worker process could be started
+  for(std::size_t i = 0; i < files.size(); ++i)
+  {
+    if(!done[i])
+    {
+      file_result res;
+      res.errors = files[i].string() + ": no worker process to parse it\n";
+      finish(i, std::move(res));
+    }
+  }
+
+  for(auto& w : workers)
+  {
+    if(w.pid >= 0)
+      reap(w, w.file != idle);
+  }
+
+  report.wall_ns = trace_clock() - start;
+  return report;
+}
+
+#else
+
+supervised_report run_supervised(std::vector<fs::path> const& files, supervisor_options const& options, batch_sink const& sink)
+{
+  auto batch = options.batch;
+  batch.jobs = options.processes;
+
+  supervised_report report;
+  static_cast<batch_report&>(report) = run_batch(files, batch, sink);
+  report.shards.resize(1);
+  for(auto& f : report.files)
+  {
+    report.shards[0].files += 1;
+    report.shards[0].bytes += f.bytes;
+    report.shards[0].busy_ns += f.latency_ns();
+  }
+  return report;
+}
+
+#endif
+
+void print_shard_stats(std::ostream& os, supervised_report const& report)
+{
+  os << std::left << std::setw(8) << "worker" << std::right
+     << std::setw(10) << "files" << std::setw(14) << "bytes" << std::setw(12) << "busy ms"
+     << std::setw(10) << "crashes" << std::setw(10) << "timeouts" << '\n';
+  for(std::size_t s = 0; s < report.shards.size(); ++s)
+  {
+    auto& shard = report.shards[s];
+    os << std::left << std::setw(8) << s << std::right
+       << std::setw(10) << shard.files << std::setw(14) << shard.bytes
+       << std::setw(12) << std::fixed << std::setprecision(3) << static_cast<double>(shard.busy_ns) / 1e6
+       << std::setw(10) << shard.crashes << std::setw(10) << shard.timeouts << '\n';
+  }
+
+  os << '\n'
+     << "restarts     " << report.restarts() << '\n'
+     << "quarantined  " << report.quarantined() << '\n';
+  for(auto& f : report.files)
+  {
+    if(!f.quarantined.empty())
+      os << "  " << f.name << ": " << f.quarantined << '\n';
+  }
+}
+
+}
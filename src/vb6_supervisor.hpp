@@ -0,0 +1,63 @@
+//: vb6_supervisor.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include "vb6_batch.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+namespace vb6_grammar {
+
+  struct supervisor_options
+  {
+    unsigned processes = 1;
+    std::chrono::milliseconds file_timeout{ 0 }; // 0 for none
+    std::filesystem::path quarantine_dir;        // where the offending files get copied, as <index>-<name>, if not empty
+    batch_options batch;                         // jobs and queue sizes are not used
+
+    // run by the worker process before every file, for fault injection
+    std::function<void(std::filesystem::path const&)> before_file;
+  };
+
+  // what one worker process did, over all its restarts
+  struct shard_stats
+  {
+    std::size_t files = 0;
+    std::size_t bytes = 0;
+    std::uint64_t busy_ns = 0; // from handing out a file to getting its result
+    unsigned crashes = 0;
+    unsigned timeouts = 0;
+  };
+
+  struct supervised_report : batch_report
+  {
+    std::vector<shard_stats> shards;
+
+    unsigned restarts() const;
+    std::size_t quarantined() const;
+  };
+
+  // Processes the files in options.processes forked worker processes, each
+  // given the next file as soon as it is done with one. A worker that dies
+  // or takes longer than the timeout on a file is killed and replaced, and
+  // the file is reported as quarantined instead of taking the run down.
+  // The results are merged into one report, and handed to the sink in the
+  // order of the inputs as run_batch does.
+  // To be called before any other thread gets started. Without fork (on
+  // Windows) this is run_batch with one thread per process.
+  supervised_report run_supervised(std::vector<std::filesystem::path> const& files, supervisor_options const& options,
+                                   batch_sink const& sink = {});
+
+  // a line per worker process, then the restarts and quarantined files
+  void print_shard_stats(std::ostream& os, supervised_report const& report);
+}
@@ -9,6 +9,7 @@
 #include "test_grammar_helper.hpp"
 #include "vb6_parser.hpp"
 #include "vb6_ast_printer.hpp"
+#include "vb6_trace.hpp"
 
 #include <iostream>
 #include <map>
@@ -29,8 +30,12 @@ void test_vb6_unit(ostream& os, std::string_view unit)
   auto const G = vb6_grammar::basModDef;
 #endif
 
-  test_grammar(os, "test_vb6_unit", G, unit, ast);
+  {
+    vb6_grammar::trace_scope trace("parse");
+    test_grammar(os, "test_vb6_unit", G, unit, ast);
+  }
 
+  vb6_grammar::trace_scope trace("print", "print");
   vb6_ast_printer P(os);
   P(ast);
 }
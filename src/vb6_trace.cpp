@@ -0,0 +1,167 @@
+//: vb6_trace.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vb6_grammar {
+
+namespace {
+
+struct event
+{
+  char const* name;
+  char const* category;
+  std::uint64_t start;
+  std::uint64_t end;
+  std::string detail;
+};
+
+struct thread_buffer
+{
+  int tid;
+  std::vector<event> events;
+};
+
+// the buffers outlive their threads, until the trace gets written
+struct trace_state
+{
+  std::mutex mutex;
+  std::string path;
+  std::uint64_t origin = 0;
+  std::vector<std::shared_ptr<thread_buffer>> buffers;
+  std::atomic<unsigned> generation = 0; // bumped when the buffers get dropped
+};
+
+trace_state& state()
+{
+  static trace_state st;
+  return st;
+}
+
+thread_buffer& local_buffer()
+{
+  thread_local std::shared_ptr<thread_buffer> buffer;
+  thread_local unsigned generation = 0;
+
+  auto& st = state();
+  if(buffer && generation == st.generation.load(std::memory_order_acquire))
+    return *buffer;
+
+  std::lock_guard lock(st.mutex);
+  buffer = std::make_shared<thread_buffer>();
+  buffer->tid = static_cast<int>(st.buffers.size()) + 1;
+  generation = st.generation.load(std::memory_order_relaxed);
+  st.buffers.push_back(buffer);
+  return *buffer;
+}
+
+void write_json_string(std::ostream& os, std::string_view str)
+{
+  os << '"';
+  for(char c : str)
+  {
+    switch(c)
+    {
+    case '"':  os << "\\\""; break;
+    case '\\': os << "\\\\"; break;
+    case '\n': os << "\\n"; break;
+    case '\r': os << "\\r"; break;
+    case '\t': os << "\\t"; break;
+    default:
+      if(static_cast<unsigned char>(c) < 0x20)
+      {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+        os << buf;
+      }
+      else
+        os << c;
+    }
+  }
+  os << '"';
+}
+
+}
+
+void start_trace(std::string path)
+{
+  auto& st = state();
+  {
+    std::lock_guard lock(st.mutex);
+    st.path = std::move(path);
+    st.buffers.clear();
+    ++st.generation;
+  }
+  st.origin = trace_clock();
+  detail::trace_on.store(true, std::memory_order_relaxed);
+}
+
+bool stop_trace()
+{
+  detail::trace_on.store(false, std::memory_order_relaxed);
+
+  auto& st = state();
+  std::lock_guard lock(st.mutex);
+
+  std::ofstream out(st.path);
+  if(!out)
+    return false;
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  bool first = true;
+  for(auto& buffer : st.buffers)
+  {
+    for(auto& ev : buffer->events)
+    {
+      auto const start = std::max(ev.start, st.origin);
+      out << (first ? "" : ",\n") << "{\"name\":";
+      write_json_string(out, ev.name);
+      out << ",\"cat\":";
+      write_json_string(out, ev.category);
+      // microseconds, as the format wants them
+      out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+          << ",\"ts\":" << (start - st.origin) / 1000 << '.' << (start - st.origin) % 1000 / 100
+          << ",\"dur\":" << (ev.end - start) / 1000 << '.' << (ev.end - start) % 1000 / 100;
+      if(!ev.detail.empty())
+      {
+        out << ",\"args\":{\"detail\":";
+        write_json_string(out, ev.detail);
+        out << '}';
+      }
+      out << '}';
+      first = false;
+    }
+  }
+  out << "\n]}\n";
+
+  st.buffers.clear();
+  ++st.generation;
+  return static_cast<bool>(out);
+}
+
+std::uint64_t trace_clock() noexcept
+{
+  using namespace std::chrono;
+  return static_cast<std::uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+void trace_event(char const* name, char const* category, std::uint64_t start, std::uint64_t end,
+                 std::string detail)
+{
+  if(!trace_enabled())
+    return;
+  local_buffer().events.push_back({ name, category, start, end, std::move(detail) });
+}
+
+}
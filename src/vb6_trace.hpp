@@ -0,0 +1,142 @@
+//: vb6_trace.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include "vb6_probes.hpp"
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace vb6_grammar {
+
+  namespace x3 = boost::spirit::x3;
+
+  // Timeline of the parsing phases in the Chrome trace event format, to be
+  // opened with chrome://tracing or Perfetto. Every thread records into a
+  // buffer of its own, the file gets written by stop_trace() once all the
+  // threads are done.
+  namespace detail {
+    inline std::atomic<bool> trace_on = false;
+  }
+
+  inline bool trace_enabled() noexcept
+  {
+    return detail::trace_on.load(std::memory_order_relaxed);
+  }
+
+  void start_trace(std::string path);
+
+  // false if the file could not be written
+  bool stop_trace();
+
+  // nanoseconds of a monotonic clock
+  std::uint64_t trace_clock() noexcept;
+
+  // records a complete event on the calling thread
+  void trace_event(char const* name, char const* category, std::uint64_t start, std::uint64_t end,
+                   std::string detail = {});
+
+  // Event lasting as long as the scope. When tracing is off it costs the
+  // test of a flag, the detail is not even copied.
+  class trace_scope
+  {
+  public:
+    explicit trace_scope(char const* name, char const* category = "parse", std::string_view detail = {})
+    {
+      if(trace_enabled())
+      {
+        event_name = name;
+        event_category = category;
+        event_detail = detail;
+        start = trace_clock();
+      }
+    }
+
+    ~trace_scope()
+    {
+      if(event_name)
+        trace_event(event_name, event_category, start, trace_clock(), std::move(event_detail));
+    }
+
+    trace_scope(trace_scope const&) = delete;
+    trace_scope& operator=(trace_scope const&) = delete;
+
+  private:
+    char const* event_name = nullptr;
+    char const* event_category = nullptr;
+    std::string event_detail;
+    std::uint64_t start = 0;
+  };
+
+  struct vb6_error_handler_tag;
+
+  // Pass-through directive recording an event for every match of its subject,
+  // with the byte range it covers, and firing the item__done probe.
+  template <typename Subject>
+  struct trace_directive : x3::unary_parser<Subject, trace_directive<Subject>>
+  {
+    using base_type = x3::unary_parser<Subject, trace_directive<Subject>>;
+    static bool const is_pass_through_unary = true;
+
+    trace_directive(Subject const& subject, char const* name)
+      : base_type(subject), name(name)
+    {
+    }
+
+    template <typename Iterator, typename Context, typename RContext, typename Attribute>
+    bool parse(Iterator& first, Iterator const& last, Context const& context, RContext& rcontext, Attribute& attr) const
+    {
+      if(!trace_enabled() && !VB6_PROBE_ENABLED(item__done))
+        return this->subject.parse(first, last, context, rcontext, attr);
+
+      // on a copy, a failing parser must leave first where it was
+      auto begin = first;
+      x3::skip_over(begin, last, context);
+      auto const start = trace_clock();
+      if(!this->subject.parse(first, last, context, rcontext, attr))
+        return false;
+      auto const end = trace_clock();
+
+      std::size_t begin_offset = 0;
+      std::size_t end_offset = 0;
+      auto const& handler = x3::get<vb6_error_handler_tag>(context);
+      if constexpr(!std::is_same_v<std::decay_t<decltype(handler)>, x3::unused_type>)
+      {
+        begin_offset = handler.get().offset_of(begin);
+        end_offset = handler.get().offset_of(first);
+      }
+
+      VB6_PROBE(item__done, name, begin_offset, end_offset, end - start);
+      if(trace_enabled())
+        trace_event(name, "parse", start, end, "bytes " + std::to_string(begin_offset) + '-' + std::to_string(end_offset));
+      return true;
+    }
+
+    char const* name;
+  };
+
+  struct trace_gen
+  {
+    char const* name;
+
+    template <typename Subject>
+    trace_directive<typename x3::extension::as_parser<Subject>::value_type>
+    operator[](Subject const& subject) const
+    {
+      return { x3::as_parser(subject), name };
+    }
+  };
+
+  inline trace_gen traced(char const* name)
+  {
+    return { name };
+  }
+}
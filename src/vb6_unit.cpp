@@ -0,0 +1,152 @@
+//: vb6_unit.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_unit.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace vb6_grammar {
+
+namespace {
+
+constexpr auto npos = std::string_view::npos;
+
+bool iequals(std::string_view a, std::string_view b)
+{
+  return a.size() == b.size()
+      && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+bool is_blank(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::string_view trim(std::string_view s)
+{
+  while(!s.empty() && is_blank(s.front()))
+    s.remove_prefix(1);
+  while(!s.empty() && is_blank(s.back()))
+    s.remove_suffix(1);
+  return s;
+}
+
+// the first word of s, which is removed from it
+std::string_view take_word(std::string_view& s)
+{
+  s = trim(s);
+  auto const end = std::min(s.find_first_of(" \t"), s.size());
+  auto const word = s.substr(0, end);
+  s.remove_prefix(end);
+  return word;
+}
+
+unit_kind kind_from_extension(std::string_view file_name)
+{
+  auto const dot = file_name.rfind('.');
+  if(dot == npos || file_name.find_first_of("/\\", dot) != npos)
+    return unit_kind::module;
+  auto const ext = file_name.substr(dot);
+  if(iequals(ext, ".cls"))
+    return unit_kind::class_module;
+  if(iequals(ext, ".frm"))
+    return unit_kind::form;
+  if(iequals(ext, ".ctl"))
+    return unit_kind::user_control;
+  return unit_kind::module;
+}
+
+// from the class of the outermost object of the designer, as VB.Form
+unit_kind designer_kind(std::string_view type, unit_kind by_extension)
+{
+  if(iequals(type, "VB.UserControl"))
+    return unit_kind::user_control;
+  if(iequals(type, "VB.Form") || iequals(type, "VB.MDIForm"))
+    return unit_kind::form;
+  // property pages, user documents and the like are parsed as forms
+  return by_extension == unit_kind::user_control ? unit_kind::user_control : unit_kind::form;
+}
+
+}
+
+char const* unit_kind_name(unit_kind kind)
+{
+  switch(kind)
+  {
+  case unit_kind::module: return "module";
+  case unit_kind::class_module: return "class";
+  case unit_kind::form: return "form";
+  case unit_kind::user_control: return "user control";
+  }
+  return "?";
+}
+
+unit_layout sniff_unit(std::string_view text, std::string_view file_name)
+{
+  unit_layout layout;
+  layout.kind = kind_from_extension(file_name);
+
+  std::size_t pos = text.starts_with("\xEF\xBB\xBF") ? 3 : 0;
+  std::size_t line = 0;
+  bool header = false;
+  std::size_t depth = 0; // of the Begin ... End blocks
+
+  while(pos < text.size())
+  {
+    auto const eol = text.find('\n', pos);
+    auto const next = eol == npos ? text.size() : eol + 1;
+    auto rest = text.substr(pos, next - pos);
+    auto const word = take_word(rest);
+
+    if(!header)
+    {
+      if(!word.empty())
+      {
+        // no header, the unit is all code
+        if(!iequals(word, "VERSION"))
+          return layout;
+        header = true;
+        rest = trim(rest);
+        if(rest.size() >= 5 && iequals(rest.substr(rest.size() - 5), "CLASS"))
+          layout.kind = unit_kind::class_module;
+      }
+    }
+    else if(iequals(word, "Begin") || iequals(word, "BeginProperty"))
+    {
+      if(depth == 0 && layout.kind != unit_kind::class_module && iequals(word, "Begin"))
+        layout.kind = designer_kind(take_word(rest), layout.kind);
+      ++depth;
+    }
+    else if(iequals(word, "End") || iequals(word, "EndProperty"))
+    {
+      if(depth > 0 && --depth == 0)
+      {
+        layout.code_begin = next;
+        layout.code_line = line + (eol != npos);
+        return layout;
+      }
+    }
+    else if(depth == 0 && !word.empty() && !iequals(word, "Object"))
+    {
+      // a header with no designer
+      layout.code_begin = pos;
+      layout.code_line = line;
+      return layout;
+    }
+
+    pos = next;
+    ++line;
+  }
+
+  // ended in the header, or before anything but blank lines
+  layout.header_ended = false;
+  return layout;
+}
+
+}
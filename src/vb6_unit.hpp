@@ -0,0 +1,52 @@
+//: vb6_unit.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace vb6_grammar {
+
+  enum class unit_kind : std::uint8_t
+  {
+    module,       // .bas
+    class_module, // .cls
+    form,         // .frm
+    user_control  // .ctl
+  };
+
+  char const* unit_kind_name(unit_kind kind);
+
+  // Forms, user controls and classes saved by the IDE start with a header
+  // the grammar does not parse, the description of the designer:
+  //
+  //   VERSION 5.00                    VERSION 1.0 CLASS
+  //   Object = "{...}#2.0#0"; "x.ocx" BEGIN
+  //   Begin VB.Form Form1               MultiUse = -1  'True
+  //      Begin VB.CommandButton Ok    END
+  //      End                          Attribute VB_Name = "Class1"
+  //   End
+  //   Attribute VB_Name = "Form1"
+  //
+  // The code, from the first Attribute on, is what all the kinds of unit
+  // have in common and what gets parsed, with the module rule.
+  struct unit_layout
+  {
+    unit_kind kind = unit_kind::module;
+    std::size_t code_begin = 0; // offset of the first line after the header
+    std::size_t code_line = 0;  // lines before it
+    bool header_ended = true;   // false if the text ends inside the header or is blank
+  };
+
+  // Tells the kind of unit from the header, else (modules and units saved
+  // without one) from the extension of file_name, and finds where the code
+  // begins. Only the header is looked at, with one pass over its lines. A
+  // header that is not closed is left in the code, to be reported by the
+  // parse.
+  unit_layout sniff_unit(std::string_view text, std::string_view file_name = {});
+}
@@ -0,0 +1,86 @@
+//: vb6_work_stealing.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace vb6_grammar {
+
+  // One deque of tasks per worker. A worker takes the task it pushed last,
+  // the one most likely still in its cache; a worker without tasks steals
+  // the oldest one of another worker, the biggest piece of work left there.
+  // The deques are short lived and small, a lock each is plenty.
+  template <typename Task>
+  class work_stealing_deques
+  {
+  public:
+    explicit work_stealing_deques(std::size_t workers)
+      : deques(workers)
+    {
+    }
+
+    std::size_t workers() const { return deques.size(); }
+
+    // tasks not taken yet, over all the workers
+    std::size_t size() const { return queued.load(std::memory_order_seq_cst); }
+
+    void push(std::size_t worker, Task task)
+    {
+      auto& d = deques[worker];
+      std::lock_guard lock(d.mutex);
+      d.tasks.push_back(std::move(task));
+      queued.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    // the newest task of the worker
+    bool pop(std::size_t worker, Task& task)
+    {
+      auto& d = deques[worker];
+      std::lock_guard lock(d.mutex);
+      if(d.tasks.empty())
+        return false;
+      task = std::move(d.tasks.back());
+      d.tasks.pop_back();
+      queued.fetch_sub(1, std::memory_order_seq_cst);
+      return true;
+    }
+
+    // the oldest task of the first other worker that has some
+    bool steal(std::size_t thief, Task& task)
+    {
+      if(queued.load(std::memory_order_relaxed) == 0)
+        return false;
+      for(std::size_t i = 1; i < deques.size(); ++i)
+      {
+        auto& d = deques[(thief + i) % deques.size()];
+        std::lock_guard lock(d.mutex);
+        if(d.tasks.empty())
+          continue;
+        task = std::move(d.tasks.front());
+        d.tasks.pop_front();
+        queued.fetch_sub(1, std::memory_order_seq_cst);
+        return true;
+      }
+      return false;
+    }
+
+  private:
+    struct alignas(64) worker_deque
+    {
+      std::mutex mutex;
+      std::deque<Task> tasks;
+    };
+
+    std::vector<worker_deque> deques;
+    std::atomic<std::size_t> queued = 0;
+  };
+}
@@ -12,6 +12,7 @@
 #include <boost/spirit/home/x3.hpp>
 
 #include <iostream>
+#include <ostream>
 #include <string_view>
 #include <utility>
 
@@ -23,7 +24,9 @@ std::pair<bool, std::string_view> test_grammar(std::string_view fragment, ruleTy
   auto it1 = cbegin(fragment);
   auto const it2 = cend(fragment);
 
-  std::stringstream out;
+  // the handler only writes from on_error, which no rule has, so one
+  // stream that discards does for every call
+  thread_local std::ostream out(nullptr);
 
   vb6_grammar::error_handler_type error_handler(it1, it2, out, "source.bas");
 
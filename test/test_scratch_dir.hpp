@@ -0,0 +1,63 @@
+//: test_scratch_dir.hpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+// A directory of the running test, removed at its end. It is named after
+// the test and the process, as ctest runs every test in a process of its
+// own and with -j many of them at once.
+struct scratch_dir
+{
+  std::filesystem::path root;
+
+  scratch_dir()
+  {
+    auto const info = ::testing::UnitTest::GetInstance()->current_test_info();
+    std::string name = info ? std::string(info->test_suite_name()) + '.' + info->name() : "vb6_parser.gtest";
+#ifdef _WIN32
+    name += '.' + std::to_string(::_getpid());
+#else
+    name += '.' + std::to_string(::getpid());
+#endif
+    std::replace(name.begin(), name.end(), '/', '_');
+    root = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+  }
+
+  ~scratch_dir()
+  {
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+  }
+
+  scratch_dir(scratch_dir const&) = delete;
+  scratch_dir& operator=(scratch_dir const&) = delete;
+
+  // creating the directories on the way
+  void write(std::string const& name, std::string_view text) const
+  {
+    auto const file = root / name;
+    std::filesystem::create_directories(file.parent_path());
+    std::ofstream(file, std::ios::binary) << text;
+  }
+
+  std::string path(std::string const& name) const { return (root / name).string(); }
+};
@@ -0,0 +1,113 @@
+//: vb6_archive.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "test_scratch_dir.hpp"
+#include "vb6_archive.hpp"
+#include "vb6_batch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct archive_sample : scratch_dir
+{
+  fs::path archive = root / ("corpus" + string(vb6_grammar::archive_extension));
+
+  archive_sample()
+  {
+    write("src/a.bas", "Sub foo()\r\n    Exit Sub\r\nEnd Sub\r\n");
+    write("src/empty.bas", "");
+    write("src/sub/b.bas", "Sub bar()\r\n    Exit Foo\r\nEnd Sub\r\n");
+  }
+};
+
+}
+
+GTEST_TEST(vb6_archive, round_trip)
+{
+  archive_sample sample;
+  stringstream err;
+  auto const inputs = vb6_grammar::collect_inputs({ (sample.root / "src").string() }, err);
+  ASSERT_EQ(inputs.size(), 3);
+  ASSERT_TRUE(vb6_grammar::write_archive(sample.archive, inputs, { sample.root / "src" }, err)) << err.str();
+
+  vb6_grammar::archive_view const view(sample.archive);
+  ASSERT_TRUE(view.ok()) << view.error();
+  ASSERT_EQ(view.size(), 3);
+  EXPECT_EQ(view[0].name, "a.bas");
+  EXPECT_EQ(view[0].contents, "Sub foo()\r\n    Exit Sub\r\nEnd Sub\r\n");
+  EXPECT_EQ(view[1].name, "empty.bas");
+  EXPECT_TRUE(view[1].contents.empty());
+  EXPECT_EQ(view[2].name, "sub/b.bas");
+
+  vb6_grammar::batch_options options;
+  options.format = vb6_grammar::output_format::json;
+  auto const from_files = vb6_grammar::run_batch(inputs, options);
+  auto const from_archive = vb6_grammar::run_batch(view, options);
+  ASSERT_EQ(from_archive.files.size(), 3);
+  EXPECT_EQ(from_archive.reader, "archive");
+  for(size_t i = 0; i < 3; ++i)
+  {
+    EXPECT_EQ(from_archive.files[i].output, from_files.files[i].output);
+    EXPECT_EQ(from_archive.files[i].failed(), from_files.files[i].failed());
+  }
+  EXPECT_EQ(from_archive.files[2].errors.rfind("sub/b.bas:2:10: expecting ", 0), 0);
+}
+
+GTEST_TEST(vb6_archive, named_per_argument)
+{
+  archive_sample sample;
+  sample.write("other/c.bas", "Sub baz()\r\nEnd Sub\r\n");
+
+  vector<string> const args{ (sample.root / "src" / "sub").string(), (sample.root / "other").string(),
+                             (sample.root / "src" / "a.bas").string() };
+  stringstream err;
+  auto const inputs = vb6_grammar::collect_inputs(args, err);
+  ASSERT_EQ(inputs.size(), 3);
+  ASSERT_TRUE(vb6_grammar::write_archive(sample.archive, inputs, vb6_grammar::archive_bases(args), err)) << err.str();
+
+  vb6_grammar::archive_view const view(sample.archive);
+  ASSERT_TRUE(view.ok()) << view.error();
+  ASSERT_EQ(view.size(), 3);
+  EXPECT_EQ(view[0].name, "b.bas");
+  EXPECT_EQ(view[1].name, "c.bas");
+  EXPECT_EQ(view[2].name, (sample.root / "src" / "a.bas").generic_string());
+}
+
+GTEST_TEST(vb6_archive, invalid)
+{
+  archive_sample sample;
+
+  EXPECT_FALSE(vb6_grammar::archive_view(sample.root / "missing.vb6pack").ok());
+  EXPECT_FALSE(vb6_grammar::archive_view(sample.root / "src" / "a.bas").ok());
+
+  stringstream err;
+  ASSERT_TRUE(vb6_grammar::write_archive(sample.archive, { sample.root / "src" / "a.bas" }, {}, err));
+  fs::resize_file(sample.archive, fs::file_size(sample.archive) - 1); // index cut short
+  vb6_grammar::archive_view const view(sample.archive);
+  EXPECT_FALSE(view.ok());
+  EXPECT_EQ(view.size(), 0);
+
+  // an entry count far beyond what the index can hold
+  ASSERT_TRUE(vb6_grammar::write_archive(sample.archive, { sample.root / "src" / "a.bas" }, {}, err));
+  {
+    fstream f(sample.archive, ios::binary | ios::in | ios::out);
+    f.seekp(12);
+    f.write("\xFF\xFF\xFF\xFF", 4);
+  }
+  vb6_grammar::archive_view const huge(sample.archive);
+  EXPECT_FALSE(huge.ok());
+  EXPECT_EQ(huge.size(), 0);
+}
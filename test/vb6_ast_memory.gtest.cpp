@@ -0,0 +1,65 @@
+//: vb6_ast_memory.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_alloc_stats.hpp"
+#include "vb6_ast_memory.hpp"
+#include "vb6_parser_api.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace std;
+
+GTEST_TEST(vb6_ast_memory, by_item_kind)
+{
+  string const unit = "Option Explicit\r\n"
+                      "Enum Colors\r\n"
+                      "    Black = 0\r\n"
+                      "    White = 1\r\n"
+                      "End Enum\r\n"
+                      "Sub a_rather_long_subroutine_name()\r\n"
+                      "    Call bar(1, 2, 3)\r\n"
+                      "    Exit Sub\r\n"
+                      "End Sub\r\n";
+
+  vb6_ast::vb_module ast;
+  ASSERT_EQ(vb6_grammar::phrase_parse_module(unit, ast).status, vb6_grammar::parse_status::ok);
+
+  auto const mem = vb6_grammar::measure_module(ast);
+
+  EXPECT_GT(mem.declarations.blocks, 0);
+  EXPECT_GT(mem.subs.blocks, 1);
+  EXPECT_EQ(mem.functions.blocks, 0);
+  EXPECT_GT(mem.others.bytes, 0);
+
+  auto const total = mem.total();
+  EXPECT_EQ(total.bytes, mem.declarations.bytes + mem.subs.bytes + mem.functions.bytes + mem.others.bytes);
+
+  // the name of the sub does not fit in the small string buffer
+  auto* sub = boost::get<vb6_ast::subDef>(&ast.back());
+  ASSERT_NE(sub, nullptr);
+  EXPECT_GE(vb6_grammar::measure_ast(sub->header.name).bytes, sub->header.name.size());
+}
+
+GTEST_TEST(vb6_ast_memory, alloc_scope)
+{
+  vb6_grammar::alloc_scope scope;
+
+  void* p1 = vb6_grammar::counted_alloc(100);
+  void* p2 = vb6_grammar::counted_alloc(50);
+  vb6_grammar::counted_free(p1);
+  void* p3 = vb6_grammar::counted_alloc(10);
+  vb6_grammar::counted_free(p2);
+  vb6_grammar::counted_free(p3);
+
+  auto const d = scope.delta();
+  EXPECT_EQ(d.allocations, 3);
+  EXPECT_EQ(d.deallocations, 3);
+  EXPECT_EQ(d.bytes, 160);
+  EXPECT_EQ(d.peak_bytes, 150);
+  EXPECT_EQ(d.live_bytes, 0);
+}
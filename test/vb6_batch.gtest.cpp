@@ -0,0 +1,230 @@
+//: vb6_batch.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "test_scratch_dir.hpp"
+#include "vb6_batch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+// a scratch directory with a few units
+struct sample_tree : scratch_dir
+{
+  sample_tree()
+  {
+    write("a.bas", "Sub foo()\r\n    Exit Sub\r\nEnd Sub\r\n");
+    write("b.bas", "Sub bar()\r\n    Exit Foo\r\nEnd Sub\r\n");
+    write("sub/c.cls", "Sub baz()\r\nEnd Sub\r\n");
+    write("notes.txt", "not a unit");
+    write("p.vbp", "Type=Exe\r\nModule=a; a.bas\r\nClass=c; sub\\c.cls\r\nName=\"p\"\r\n");
+  }
+};
+
+vector<string> names(vector<fs::path> const& paths)
+{
+  vector<string> res;
+  for(auto& p : paths)
+    res.push_back(p.filename().string());
+  return res;
+}
+
+}
+
+GTEST_TEST(vb6_batch, collect_inputs)
+{
+  sample_tree tree;
+  stringstream err;
+
+  EXPECT_EQ(names(vb6_grammar::collect_inputs({ tree.root.string() }, err)), (vector<string>{ "a.bas", "b.bas", "c.cls" }));
+  EXPECT_EQ(names(vb6_grammar::collect_inputs({ tree.path("*.bas") }, err)), (vector<string>{ "a.bas", "b.bas" }));
+  EXPECT_EQ(names(vb6_grammar::collect_inputs({ tree.path("p.vbp"), tree.path("a.bas") }, err)), (vector<string>{ "a.bas", "c.cls" }));
+  EXPECT_TRUE(err.str().empty());
+
+  EXPECT_TRUE(vb6_grammar::collect_inputs({ tree.path("missing.bas") }, err).empty());
+  EXPECT_EQ(err.str(), "No such file: " + tree.path("missing.bas") + '\n');
+}
+
+GTEST_TEST(vb6_batch, run_batch)
+{
+  sample_tree tree;
+  stringstream err;
+  auto const inputs = vb6_grammar::collect_inputs({ tree.path("*.bas"), tree.path("missing.bas") }, err);
+
+  vb6_grammar::batch_options options;
+  options.jobs = 2;
+  options.format = vb6_grammar::output_format::json;
+  auto const report = vb6_grammar::run_batch(inputs, options);
+
+  ASSERT_EQ(report.files.size(), 2);
+  EXPECT_EQ(report.failures(), 1);
+  EXPECT_EQ(report.bytes(), 34 + 34);
+
+  auto& a = report.files[0];
+  EXPECT_FALSE(a.failed());
+  EXPECT_EQ(a.output, R"([{"header":{"at":0,"name":"foo","params":[]},"statements":[{"type":0}]}])" "\n");
+  EXPECT_TRUE(a.errors.empty());
+
+  auto& b = report.files[1];
+  EXPECT_TRUE(b.failed());
+  EXPECT_TRUE(b.output.empty());
+  EXPECT_EQ(b.errors, tree.path("b.bas") + ":2:10: expecting Sub, Function, Property, Do, While or For\n");
+
+  EXPECT_LE(report.latency_percentile(50), report.latency_percentile(99));
+  EXPECT_EQ(report.latency_percentile(100), max(a.latency_ns(), b.latency_ns()));
+}
+
+GTEST_TEST(vb6_batch, sink_in_order)
+{
+  sample_tree tree;
+  for(int i = 0; i < 20; ++i)
+  {
+    // appended rather than concatenated, which trips -Wrestrict in GCC 12
+    string name = "m";
+    name += to_string(100 + i);
+    name += ".bas";
+    tree.write(name, i % 3 ? "Sub foo()\r\nEnd Sub\r\n" : "Sub foo()\r\n    Exit Foo\r\nEnd Sub\r\n");
+  }
+  stringstream err;
+  auto const inputs = vb6_grammar::collect_inputs({ tree.path("m*.bas") }, err);
+  ASSERT_EQ(inputs.size(), 20);
+
+  vb6_grammar::batch_options options;
+  options.jobs = 3;
+  options.queue_depth = 1;
+  options.format = vb6_grammar::output_format::vb;
+
+  vector<string> seen;
+  string errors;
+  auto const report = vb6_grammar::run_batch(inputs, options, [&](vb6_grammar::file_result const& f) {
+    seen.push_back(f.name);
+    EXPECT_EQ(f.output.empty(), f.failed());
+    errors += f.errors;
+  });
+
+  ASSERT_EQ(seen.size(), inputs.size());
+  for(size_t i = 0; i < inputs.size(); ++i)
+    EXPECT_EQ(seen[i], inputs[i].string());
+  EXPECT_EQ(report.failures(), 7);
+  EXPECT_EQ(count(errors.begin(), errors.end(), '\n'), 7);
+  for(auto& f : report.files)
+    EXPECT_TRUE(f.output.empty() && f.errors.empty());
+}
+
+GTEST_TEST(vb6_batch, big_files_in_pieces)
+{
+  sample_tree tree;
+  string unit = "Option Explicit\r\n";
+  for(int i = 0; i < 50; ++i)
+    unit += "Sub foo" + to_string(i) + "()\r\n    x = y\r\n    Call bar(\"item\", 1, counter)\r\nEnd Sub\r\n";
+  tree.write("big.bas", unit);
+  tree.write("bad.bas", unit + "Sub bad()\r\n    Exit Foo\r\nEnd Sub\r\n" + unit);
+  stringstream err;
+  auto const inputs = vb6_grammar::collect_inputs({ tree.path("big.bas"), tree.path("bad.bas") }, err);
+
+  vb6_grammar::batch_options options;
+  options.format = vb6_grammar::output_format::vb;
+  options.piece_bytes = 0;
+  auto const whole = vb6_grammar::run_batch(inputs, options);
+
+  options.jobs = 3;
+  options.piece_bytes = 200;
+  auto const pieces = vb6_grammar::run_batch(inputs, options);
+
+  ASSERT_EQ(whole.files.size(), 2);
+  ASSERT_EQ(pieces.files.size(), 2);
+  EXPECT_FALSE(pieces.files[0].failed());
+  EXPECT_EQ(pieces.files[0].output, whole.files[0].output);
+  EXPECT_TRUE(pieces.files[1].failed());
+  EXPECT_EQ(pieces.files[1].errors, whole.files[1].errors);
+  EXPECT_EQ(pieces.files[1].errors.rfind(tree.path("bad.bas") + ":203:10: expecting ", 0), 0);
+}
+
+GTEST_TEST(vb6_batch, duplicates_parsed_once)
+{
+  sample_tree tree;
+  for(int i = 0; i < 12; ++i)
+  {
+    string name = "d";
+    name += to_string(100 + i);
+    name += ".bas";
+    tree.write(name, i % 4 ? "Sub foo()\r\n    x = y\r\nEnd Sub\r\n" : "Sub foo()\r\n    Exit Foo\r\nEnd Sub\r\n");
+  }
+  stringstream err;
+  auto const inputs = vb6_grammar::collect_inputs({ tree.path("d*.bas") }, err);
+  ASSERT_EQ(inputs.size(), 12);
+
+  vb6_grammar::batch_options options;
+  options.jobs = 2;
+  options.format = vb6_grammar::output_format::vb;
+  options.deduplicate = false;
+  auto const all = vb6_grammar::run_batch(inputs, options);
+
+  options.deduplicate = true;
+  auto const once = vb6_grammar::run_batch(inputs, options);
+
+  EXPECT_EQ(all.duplicates(), 0);
+  EXPECT_EQ(once.duplicates(), 10);
+  EXPECT_EQ(once.duplicate_bytes(), once.bytes() - once.files[0].bytes - once.files[1].bytes);
+  EXPECT_EQ(once.failures(), 3);
+  ASSERT_EQ(once.files.size(), all.files.size());
+  for(size_t i = 0; i < all.files.size(); ++i)
+  {
+    EXPECT_EQ(once.files[i].status, all.files[i].status);
+    EXPECT_EQ(once.files[i].output, all.files[i].output);
+    EXPECT_EQ(once.files[i].errors, all.files[i].errors);
+  }
+  EXPECT_TRUE(once.files[1].duplicate_of.empty());
+  EXPECT_EQ(once.files[5].duplicate_of, inputs[1].string());
+  EXPECT_EQ(once.files[8].duplicate_of, inputs[0].string());
+  EXPECT_EQ(once.files[8].errors.rfind(inputs[8].string() + ":2:10: expecting ", 0), 0);
+}
+
+GTEST_TEST(vb6_batch, hash_collisions_compared)
+{
+  sample_tree tree;
+  tree.write("h1.bas", "Sub foo()\r\n    x = y\r\nEnd Sub\r\n");
+  tree.write("h2.bas", "Sub foo()\r\n    Exit Foo\r\nEnd Sub\r\n");
+  tree.write("h3.bas", "Sub foo()\r\n    x = y\r\nEnd Sub\r\n");
+  tree.write("h4.bas", "Sub foo()\r\n    y = x\r\nEnd Sub\r\n"); // same size as h1
+  stringstream err;
+  auto const inputs = vb6_grammar::collect_inputs({ tree.path("h*.bas") }, err);
+  ASSERT_EQ(inputs.size(), 4);
+
+  vb6_grammar::batch_options options;
+  options.format = vb6_grammar::output_format::vb;
+  options.content_hash = [](string_view) -> uint64_t { return 42; }; // everything collides
+
+  auto check = [&](vb6_grammar::batch_report const& report) {
+    ASSERT_EQ(report.files.size(), 4);
+    EXPECT_EQ(report.duplicates(), 1);
+    EXPECT_TRUE(report.files[1].duplicate_of.empty());
+    EXPECT_TRUE(report.files[1].failed());
+    EXPECT_EQ(report.files[2].duplicate_of, report.files[0].name);
+    EXPECT_TRUE(report.files[3].duplicate_of.empty());
+    EXPECT_FALSE(report.files[3].failed());
+    EXPECT_NE(report.files[3].output, report.files[0].output);
+  };
+  check(vb6_grammar::run_batch(inputs, options));
+
+  // the entries of an archive are compared where they are
+  auto const archive = tree.root / ("h" + string(vb6_grammar::archive_extension));
+  ASSERT_TRUE(vb6_grammar::write_archive(archive, inputs, { tree.root }, err)) << err.str();
+  vb6_grammar::archive_view const view(archive);
+  ASSERT_TRUE(view.ok()) << view.error();
+  check(vb6_grammar::run_batch(view, options));
+}
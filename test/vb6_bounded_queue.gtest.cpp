@@ -0,0 +1,126 @@
+//: vb6_bounded_queue.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_bounded_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+GTEST_TEST(vb6_bounded_queue, fifo_and_full)
+{
+  vb6_grammar::bounded_queue<int> q(3);
+  ASSERT_EQ(q.capacity(), 4);
+
+  for(int i = 0; i < 4; ++i)
+    EXPECT_TRUE(q.try_push(i));
+  int extra = 4;
+  EXPECT_FALSE(q.try_push(extra));
+
+  int value = -1;
+  EXPECT_TRUE(q.try_pop(value));
+  EXPECT_EQ(value, 0);
+  EXPECT_TRUE(q.try_push(extra));
+
+  for(int i = 1; i <= 4; ++i)
+  {
+    EXPECT_TRUE(q.try_pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(q.try_pop(value));
+}
+
+GTEST_TEST(vb6_bounded_queue, close_drains)
+{
+  vb6_grammar::bounded_queue<int> q(4);
+  int one = 1, two = 2;
+  q.push(one);
+  q.push(two);
+  q.close();
+
+  int three = 3;
+  EXPECT_FALSE(q.push(three));
+
+  int value = 0;
+  EXPECT_TRUE(q.pop(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(q.pop(value));
+  EXPECT_EQ(value, 2);
+  EXPECT_FALSE(q.pop(value));
+}
+
+GTEST_TEST(vb6_bounded_queue, many_producers_and_consumers)
+{
+  constexpr int producers = 3, consumers = 3, per_producer = 20000;
+  vb6_grammar::bounded_queue<int> q(8);
+  atomic<int64_t> sum = 0;
+  atomic<int> count = 0;
+
+  vector<thread> threads;
+  for(int p = 0; p < producers; ++p)
+  {
+    threads.emplace_back([&q, p] {
+      for(int i = 1; i <= per_producer; ++i)
+      {
+        int value = p * per_producer + i;
+        q.push(value);
+      }
+    });
+  }
+  for(int c = 0; c < consumers; ++c)
+  {
+    threads.emplace_back([&] {
+      for(int value; q.pop(value);)
+      {
+        sum += value;
+        ++count;
+      }
+    });
+  }
+  for(int p = 0; p < producers; ++p)
+    threads[static_cast<size_t>(p)].join();
+  q.close();
+  for(size_t t = producers; t < threads.size(); ++t)
+    threads[t].join();
+
+  int64_t const n = producers * per_producer;
+  EXPECT_EQ(count, n);
+  EXPECT_EQ(sum, n * (n + 1) / 2);
+}
+
+GTEST_TEST(vb6_bounded_queue, idle_consumers_block)
+{
+  vb6_grammar::bounded_queue<int> q(4);
+  vector<thread> threads;
+  atomic<int> got = 0;
+  for(int c = 0; c < 4; ++c)
+  {
+    threads.emplace_back([&] {
+      for(int value; q.pop(value);)
+        got += value;
+    });
+  }
+
+  // waiting on an empty queue costs next to no processor time
+  auto const cpu_before = clock();
+  this_thread::sleep_for(chrono::milliseconds(300));
+  auto const cpu_ms = (clock() - cpu_before) * 1000.0 / CLOCKS_PER_SEC;
+  EXPECT_LT(cpu_ms, 100.0);
+
+  int one = 1;
+  q.push(one);
+  q.close();
+  for(auto& t : threads)
+    t.join();
+  EXPECT_EQ(got, 1);
+}
@@ -0,0 +1,91 @@
+//: vb6_file_reader.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "test_scratch_dir.hpp"
+#include "vb6_file_reader.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+// files of sizes around the read sizes, one of them missing
+struct read_sample : scratch_dir
+{
+  vector<fs::path> files;
+  vector<string> contents;
+
+  read_sample()
+  {
+    for(size_t size : { 0, 1, 4095, 65536, 65537, 300000 })
+    {
+      string text(size, ' ');
+      for(size_t i = 0; i < size; ++i)
+        text[i] = static_cast<char>('a' + (i * 7 + size) % 26);
+      string name = "f";
+      name += to_string(size);
+      name += ".bas";
+      write(name, text);
+      files.push_back(root / name);
+      contents.push_back(text);
+    }
+    files.push_back(root / "missing.bas");
+  }
+
+  void check(vb6_grammar::file_reader& reader, size_t depth)
+  {
+    size_t next = 0;
+    vector<bool> seen(files.size());
+    for(vb6_grammar::read_result res;;)
+    {
+      for(; next < files.size() && reader.in_flight() < depth; ++next)
+        reader.submit(next, files[next]);
+      if(!reader.wait(res))
+        break;
+
+      ASSERT_LT(res.index, files.size());
+      EXPECT_FALSE(seen[res.index]);
+      seen[res.index] = true;
+      EXPECT_LE(res.start, res.end);
+      if(res.index < contents.size())
+      {
+        EXPECT_TRUE(res.ok);
+        EXPECT_EQ(res.contents, contents[res.index]) << files[res.index];
+      }
+      else
+        EXPECT_FALSE(res.ok);
+    }
+    EXPECT_EQ(next, files.size());
+    EXPECT_EQ(reader.in_flight(), 0);
+  }
+};
+
+}
+
+GTEST_TEST(vb6_file_reader, threads)
+{
+  read_sample sample;
+  auto reader = vb6_grammar::make_file_reader(3, false);
+  EXPECT_STREQ(reader->name(), "threads");
+  sample.check(*reader, 3);
+}
+
+GTEST_TEST(vb6_file_reader, io_uring_or_fallback)
+{
+  read_sample sample;
+  auto reader = vb6_grammar::make_file_reader(3);
+  sample.check(*reader, 3);
+
+  // more submitted than it reads at once
+  auto wide = vb6_grammar::make_file_reader(2);
+  sample.check(*wide, 100);
+}
@@ -0,0 +1,80 @@
+//: vb6_lazy_module.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_lazy_module.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static string_view const unit = "Option Explicit\r\n"
+                                "Sub foo()\r\n"
+                                "    Call bar(1)\r\n"
+                                "    Exit Sub\r\n"
+                                "End Sub\r\n"
+                                "Sub bar()\r\n"
+                                "    Exit Foo\r\n"
+                                "End Sub\r\n"
+                                "Enum Colors\r\n"
+                                "    Black\r\n"
+                                "End Enum\r\n";
+
+GTEST_TEST(vb6_lazy_module, bodies_parsed_on_demand)
+{
+  vb6_grammar::lazy_module module(unit);
+
+  ASSERT_EQ(module.procedures().size(), 2);
+  ASSERT_EQ(module.declarations().size(), 1);
+  EXPECT_TRUE(module.diagnostics().empty());
+  EXPECT_EQ(module.materialized_count(), 0);
+
+  auto* foo = module.find("FOO");
+  ASSERT_NE(foo, nullptr);
+  EXPECT_EQ(foo->body_source(), "Call bar(1)\r\n    Exit Sub\r\n");
+
+  EXPECT_EQ(foo->body().size(), 2);
+  EXPECT_EQ(foo->body_result().status, vb6_grammar::parse_status::ok);
+  EXPECT_EQ(foo->body_result().consumed, unit.find("End Sub"));
+  EXPECT_TRUE(foo->materialized());
+  EXPECT_EQ(module.materialized_count(), 1);
+}
+
+GTEST_TEST(vb6_lazy_module, body_diagnostics_refer_to_the_unit)
+{
+  vb6_grammar::lazy_module module(unit);
+
+  auto* bar = module.find("bar");
+  ASSERT_NE(bar, nullptr);
+
+  auto& res = bar->body_result();
+  EXPECT_EQ(res.status, vb6_grammar::parse_status::syntax_error);
+  ASSERT_EQ(res.diagnostics.size(), 1);
+  EXPECT_EQ(res.diagnostics[0].offset, unit.find("Foo"));
+  EXPECT_EQ(res.consumed, unit.find("Exit Foo"));
+}
+
+GTEST_TEST(vb6_lazy_module, concurrent_access_parses_once)
+{
+  vb6_grammar::lazy_module module(unit);
+  auto* foo = module.find("foo");
+  ASSERT_NE(foo, nullptr);
+
+  vector<vb6_ast::statements::statement_block const*> seen(8);
+  vector<thread> threads;
+  for(size_t i = 0; i < seen.size(); ++i)
+    threads.emplace_back([&, i] { seen[i] = &foo->body(); });
+  for(auto& t : threads)
+    t.join();
+
+  for(auto* p : seen)
+    EXPECT_EQ(p, seen[0]);
+  EXPECT_EQ(seen[0]->size(), 2);
+  EXPECT_EQ(module.materialized_count(), 1);
+}
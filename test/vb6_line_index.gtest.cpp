@@ -0,0 +1,81 @@
+//: vb6_line_index.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_config.hpp"
+#include "vb6_line_index.hpp"
+#include "vb6_parser_api.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+GTEST_TEST(vb6_line_index, matches_a_plain_scan)
+{
+  // lines of growing length, so that newlines fall everywhere in the 16 byte blocks
+  string buffer;
+  for(int i = 0; i < 100; ++i)
+    buffer += string(static_cast<size_t>(i % 37), 'x') + "\r\n";
+  buffer += "last line without newline";
+
+  vb6_grammar::line_index const simd(buffer);
+  vb6_grammar::line_index const plain(cbegin(buffer), cend(buffer));
+
+  ASSERT_EQ(simd.line_count(), 101);
+  EXPECT_EQ(plain.line_count(), simd.line_count());
+  EXPECT_EQ(vb6_grammar::count_newlines(buffer), 100);
+
+  size_t line = 1;
+  size_t column = 1;
+  for(size_t offset = 0; offset < buffer.size(); ++offset)
+  {
+    auto const pos = simd.position(offset);
+    ASSERT_EQ(pos.line, line) << "offset " << offset;
+    ASSERT_EQ(pos.column, column) << "offset " << offset;
+    if(buffer[offset] == '\n')
+    {
+      ++line;
+      column = 1;
+    }
+    else
+      ++column;
+  }
+}
+
+GTEST_TEST(vb6_line_index, empty_buffer)
+{
+  vb6_grammar::line_index const idx(string_view{});
+  EXPECT_EQ(idx.line_count(), 1);
+  EXPECT_EQ(idx.position(0).line, 1);
+  EXPECT_EQ(idx.position(0).column, 1);
+}
+
+GTEST_TEST(vb6_line_index, error_handler_report)
+{
+  string_view const src = "Sub foo()\r\n    Exit Foo\r\nEnd Sub\r\n";
+
+  stringstream out;
+  vb6_grammar::error_handler_type error_handler(cbegin(src), cend(src), out, "source.bas");
+  error_handler(cbegin(src) + src.find("Foo"), "Error! Expecting: exit type");
+
+  EXPECT_EQ(out.str(), "In file source.bas, line 2:\n"
+                       "Error! Expecting: exit type\n"
+                       "    Exit Foo\n"
+                       "_________^_\n");
+}
+
+GTEST_TEST(vb6_line_index, diagnostics_have_line_and_column)
+{
+  vb6_ast::statements::statement_block ast;
+  auto res = vb6_grammar::phrase_parse_statements("Call foo(1)\r\nExit Foo\r\n", ast);
+
+  ASSERT_EQ(res.diagnostics.size(), 1);
+  EXPECT_EQ(res.diagnostics[0].where.line, 2);
+  EXPECT_EQ(res.diagnostics[0].where.column, 6);
+}
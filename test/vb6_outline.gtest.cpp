@@ -0,0 +1,125 @@
+//: vb6_outline.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_outline.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+GTEST_TEST(vb6_outline, procedures_and_declarations)
+{
+  string_view const unit = "Option Explicit\r\n"
+                           "Private Sub foo()\r\n"
+                           "    Call bar(1)\r\n"
+                           "End Sub\r\n"
+                           "Public Function bar() As Long\r\n"
+                           "    bar = 1\r\n"
+                           "End Function\r\n"
+                           "Enum Colors\r\n"
+                           "    Black = 0\r\n"
+                           "    White\r\n"
+                           "End Enum\r\n"
+                           "Property Get Title() As String\r\n"
+                           "End Property\r\n";
+
+  auto const outline = vb6_grammar::parse_outline(unit);
+
+  EXPECT_TRUE(outline.diagnostics.empty());
+  ASSERT_EQ(outline.entries.size(), 4);
+
+  auto& e1 = outline.entries[0];
+  EXPECT_EQ(e1.kind, vb6_grammar::outline_kind::sub);
+  EXPECT_EQ(e1.at, vb6_ast::access_type::private_);
+  EXPECT_EQ(e1.name, "foo");
+  EXPECT_EQ(unit.substr(e1.begin, e1.head_end - e1.begin), "Private Sub foo()");
+  EXPECT_EQ(e1.end, unit.find("Public Function"));
+
+  auto& e2 = outline.entries[1];
+  EXPECT_EQ(e2.kind, vb6_grammar::outline_kind::function);
+  EXPECT_EQ(e2.name, "bar");
+  EXPECT_EQ(unit.substr(e2.begin, e2.head_end - e2.begin), "Public Function bar() As Long");
+
+  EXPECT_EQ(outline.entries[2].kind, vb6_grammar::outline_kind::enumeration);
+  EXPECT_EQ(outline.entries[2].name, "Colors");
+
+  EXPECT_EQ(outline.entries[3].kind, vb6_grammar::outline_kind::property_get);
+  EXPECT_EQ(outline.entries[3].name, "Title");
+  EXPECT_EQ(outline.entries[3].end, unit.size());
+}
+
+GTEST_TEST(vb6_outline, body_scan_skips_strings_and_comments)
+{
+  string_view const unit = "Sub foo()\r\n"
+                           "    s = \"End Sub\"\r\n"
+                           "    ' End Sub _\r\n"
+                           "End Sub\r\n"
+                           "    Rem End Sub\r\n"
+                           "    x = 1: End Sub\r\n"
+                           "Sub bar()\r\n"
+                           "End Sub\r\n";
+
+  auto const outline = vb6_grammar::parse_outline(unit);
+
+  EXPECT_TRUE(outline.diagnostics.empty());
+  ASSERT_EQ(outline.entries.size(), 2);
+  EXPECT_EQ(outline.entries[0].end, unit.find("Sub bar"));
+  EXPECT_EQ(outline.entries[1].name, "bar");
+}
+
+GTEST_TEST(vb6_outline, bad_head_is_skipped)
+{
+  string_view const unit = "Sub foo(\r\n"
+                           "    x = 1\r\n"
+                           "End Sub\r\n"
+                           "Sub bar()\r\n";
+
+  auto const outline = vb6_grammar::parse_outline(unit);
+
+  ASSERT_EQ(outline.entries.size(), 1);
+  EXPECT_EQ(outline.entries[0].name, "bar");
+
+  ASSERT_EQ(outline.diagnostics.size(), 2);
+  EXPECT_EQ(outline.diagnostics[0].offset, 0);
+  EXPECT_EQ(outline.diagnostics[0].which, "subHead");
+  EXPECT_EQ(outline.diagnostics[1].offset, unit.size()); // End Sub is missing
+}
+
+GTEST_TEST(vb6_outline, split_module)
+{
+  string_view const unit = "Option Explicit\r\n"
+                           "Sub foo()\r\n"
+                           "    Exit Sub\r\n"
+                           "End Sub\r\n"
+                           "  Private Function bar()\r\n"
+                           "End Function\r\n"
+                           "Sub baz()\r\n"
+                           "End Sub\r\n";
+
+  EXPECT_EQ(vb6_grammar::split_module(unit, 1), (vector<size_t>{ 0, unit.find("Sub foo"), unit.find("  Private"), unit.find("Sub baz") }));
+  EXPECT_EQ(vb6_grammar::split_module(unit, 45), (vector<size_t>{ 0, unit.find("  Private") }));
+  EXPECT_EQ(vb6_grammar::split_module(unit, 1000), (vector<size_t>{ 0 }));
+  EXPECT_EQ(vb6_grammar::split_module("Sub foo(\r\nEnd Sub\r\nSub bar()\r\nEnd Sub\r\n", 1), (vector<size_t>{ 0 }));
+}
+
+GTEST_TEST(vb6_outline, complete_items_end)
+{
+  string_view const unit = "Option Explicit\r\n"
+                           "Sub foo()\r\n"
+                           "    Call bar(1, _\r\n"
+                           "             2)\r\n"
+                           "End Sub\r\n"
+                           "Dim x\r\n";
+
+  EXPECT_EQ(vb6_grammar::complete_items_end(unit), unit.size());
+  EXPECT_EQ(vb6_grammar::complete_items_end(unit.substr(0, unit.size() - 1)), unit.find("Dim"));
+  EXPECT_EQ(vb6_grammar::complete_items_end(unit.substr(0, unit.find("End Sub"))), unit.find("Sub foo"));
+  EXPECT_EQ(vb6_grammar::complete_items_end(unit.substr(0, unit.find("2)"))), unit.find("Sub foo"));
+  EXPECT_EQ(vb6_grammar::complete_items_end("Option Explicit"), 0);
+}
@@ -0,0 +1,263 @@
+//: vb6_parser_api.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_parser_api.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+
+using namespace std;
+namespace x3 = boost::spirit::x3;
+
+static string make_module(int nr_subs)
+{
+  string unit = "Option Explicit\r\n";
+  for(int i = 0; i < nr_subs; ++i)
+  {
+    unit += "' sub number " + to_string(i) + "\r\n"
+            "Sub foo" + to_string(i) + "()\r\n"
+            "    Call bar(" + to_string(i) + ")\r\n"
+            "    Exit Sub\r\n"
+            "End Sub\r\n";
+  }
+  return unit;
+}
+
+GTEST_TEST(vb6_parser_api, module_unlimited)
+{
+  auto const unit = make_module(10);
+
+  vb6_ast::vb_module ast;
+  auto res = vb6_grammar::phrase_parse_module(unit, ast);
+
+  EXPECT_EQ(res.status, vb6_grammar::parse_status::ok);
+  EXPECT_EQ(res.consumed, unit.size());
+  EXPECT_TRUE(res.diagnostics.empty());
+  EXPECT_EQ(ast.size(), 21);
+}
+
+GTEST_TEST(vb6_parser_api, module_step_budget)
+{
+  auto const unit = make_module(100);
+
+  vb6_grammar::parse_budget budget;
+  budget.max_steps = 50;
+
+  vb6_ast::vb_module ast;
+  auto res = vb6_grammar::phrase_parse_module(unit, ast, budget);
+
+  EXPECT_EQ(res.status, vb6_grammar::parse_status::budget_exhausted);
+  EXPECT_LT(res.consumed, unit.size());
+  EXPECT_TRUE(res.diagnostics.empty());
+  EXPECT_FALSE(ast.empty());
+  EXPECT_LT(ast.size(), 201);
+}
+
+GTEST_TEST(vb6_parser_api, module_time_budget)
+{
+  auto const unit = make_module(20000);
+
+  vb6_grammar::parse_budget budget;
+  budget.max_time = chrono::microseconds(100);
+
+  vb6_ast::vb_module ast;
+  auto res = vb6_grammar::phrase_parse_module(unit, ast, budget);
+
+  EXPECT_EQ(res.status, vb6_grammar::parse_status::budget_exhausted);
+  EXPECT_LT(ast.size(), 40001);
+}
+
+GTEST_TEST(vb6_parser_api, module_cancelled)
+{
+  auto const unit = make_module(10);
+
+  atomic<bool> cancel = true;
+  vb6_grammar::parse_budget budget;
+  budget.cancel = &cancel;
+
+  vb6_ast::vb_module ast;
+  auto res = vb6_grammar::phrase_parse_module(unit, ast, budget);
+
+  EXPECT_EQ(res.status, vb6_grammar::parse_status::cancelled);
+  EXPECT_EQ(res.consumed, 0);
+  EXPECT_TRUE(ast.empty());
+}
+
+GTEST_TEST(vb6_parser_api, statements_syntax_error)
+{
+  vb6_ast::statements::statement_block ast;
+  auto res = vb6_grammar::phrase_parse_statements("Call foo(1)\r\nExit Foo\r\n", ast);
+
+  EXPECT_EQ(res.status, vb6_grammar::parse_status::syntax_error);
+  EXPECT_EQ(res.consumed, 13);
+  ASSERT_EQ(res.diagnostics.size(), 1);
+  EXPECT_EQ(res.diagnostics[0].offset, 18);
+  EXPECT_EQ(ast.size(), 1);
+}
+
+GTEST_TEST(vb6_parser_api, check_syntax_valid)
+{
+  auto const unit = make_module(10);
+
+  auto res = vb6_grammar::check_syntax(unit);
+
+  EXPECT_EQ(res.status, vb6_grammar::parse_status::ok);
+  EXPECT_EQ(res.consumed, unit.size());
+  EXPECT_TRUE(res.diagnostics.empty());
+}
+
+GTEST_TEST(vb6_parser_api, check_syntax_error)
+{
+  auto const unit = make_module(2) + "Sub foo()\r\n    Exit Foo\r\nEnd Sub\r\n";
+
+  vb6_ast::vb_module ast;
+  auto const full = vb6_grammar::phrase_parse_module(unit, ast);
+  auto const res = vb6_grammar::check_syntax(unit);
+
+  EXPECT_EQ(res.status, vb6_grammar::parse_status::syntax_error);
+  EXPECT_EQ(res.consumed, full.consumed);
+  ASSERT_EQ(res.diagnostics.size(), full.diagnostics.size());
+  ASSERT_FALSE(res.diagnostics.empty());
+  EXPECT_EQ(res.diagnostics.back().offset, unit.find("Foo\r\nEnd"));
+}
+
+GTEST_TEST(vb6_parser_api, module_spans)
+{
+  auto const unit = make_module(2);
+
+  vb6_ast::vb_module ast;
+  vb6_grammar::span_table spans;
+  auto res = vb6_grammar::phrase_parse_module(unit, ast, spans);
+  ASSERT_EQ(res.status, vb6_grammar::parse_status::ok);
+
+  auto* sub = boost::get<vb6_ast::subDef>(&ast.back());
+  ASSERT_NE(sub, nullptr);
+
+  auto text = [&](x3::position_tagged const& node) {
+    auto const sp = spans.span_of(node);
+    return string_view(unit).substr(sp.begin, sp.end - sp.begin);
+  };
+  EXPECT_EQ(text(*sub), "Sub foo1()\r\n    Call bar(1)\r\n    Exit Sub\r\nEnd Sub\r\n");
+  EXPECT_EQ(text(sub->header), "Sub foo1()\r\n");
+  EXPECT_EQ(sizeof(vb6_grammar::source_span), 8);
+}
+
+GTEST_TEST(vb6_parser_api, module_without_spans)
+{
+  auto const unit = make_module(1);
+
+  vb6_ast::vb_module ast;
+  vb6_grammar::phrase_parse_module(unit, ast);
+
+  auto* sub = boost::get<vb6_ast::subDef>(&ast.back());
+  ASSERT_NE(sub, nullptr);
+  EXPECT_EQ(sub->id_first, -1);
+}
+
+GTEST_TEST(vb6_parser_api, module_coverage)
+{
+  string_view const unit = "Sub foo()\r\n"
+                           "    On Error GoTo 0\r\n"
+                           "    On Error GoTo 0\r\n"
+                           "End Sub\r\n";
+
+  vb6_ast::vb_module ast;
+  vb6_grammar::coverage_counters coverage;
+  auto res = vb6_grammar::phrase_parse_module(unit, ast, coverage);
+  ASSERT_EQ(res.status, vb6_grammar::parse_status::ok);
+
+  auto const goto_0 = coverage.at(vb6_grammar::register_coverage_site("onerrorStmt", "GoTo 0"));
+  EXPECT_EQ(goto_0.tries, 2);
+  EXPECT_EQ(goto_0.hits, 2);
+
+  auto const resume_next = coverage.at(vb6_grammar::register_coverage_site("onerrorStmt", "Resume Next"));
+  EXPECT_EQ(resume_next.tries, 2);
+  EXPECT_EQ(resume_next.hits, 0);
+
+  auto const onerror = coverage.at(vb6_grammar::register_coverage_site("singleStmt1", "onerrorStmt"));
+  EXPECT_EQ(onerror.hits, 2);
+
+  auto const exit_sub = coverage.at(vb6_grammar::register_coverage_site("onerrorStmt", "Exit Sub"));
+  EXPECT_EQ(exit_sub.tries, 0);
+}
+
+GTEST_TEST(vb6_parser_api, session_reuse)
+{
+  vb6_grammar::parse_session session;
+
+  auto const unit = make_module(10);
+  auto const& res = session.parse_module(unit);
+  EXPECT_EQ(res.status, vb6_grammar::parse_status::ok);
+  EXPECT_EQ(session.module().size(), 21);
+  auto const capacity = session.module().capacity();
+
+  auto const& bad = session.parse_module("Sub foo()\r\n    Exit Foo\r\nEnd Sub\r\n");
+  EXPECT_EQ(&bad, &res);
+  EXPECT_EQ(bad.status, vb6_grammar::parse_status::syntax_error);
+  ASSERT_EQ(bad.diagnostics.size(), 1);
+  EXPECT_EQ(bad.diagnostics[0].where.line, 2);
+  EXPECT_EQ(session.module().capacity(), capacity);
+
+  session.parse_module(make_module(2));
+  EXPECT_EQ(session.result().status, vb6_grammar::parse_status::ok);
+  EXPECT_TRUE(session.result().diagnostics.empty());
+  EXPECT_EQ(session.module().size(), 5);
+
+  EXPECT_EQ(session.parse_statements("x = y\r\n").status, vb6_grammar::parse_status::ok);
+  EXPECT_EQ(session.statements().size(), 1);
+  EXPECT_EQ(session.parse_statements("Call bar(1)\r\n").status, vb6_grammar::parse_status::ok);
+  EXPECT_EQ(session.statements().size(), 1);
+
+  EXPECT_EQ(session.check_syntax(unit).status, vb6_grammar::parse_status::ok);
+}
+
+GTEST_TEST(vb6_parser_api, parse_module_options)
+{
+  auto const unit = make_module(3);
+
+  auto const plain = vb6_grammar::parse_module(unit);
+  EXPECT_EQ(plain.result.status, vb6_grammar::parse_status::ok);
+  EXPECT_EQ(plain.ast.size(), 7);
+  EXPECT_EQ(plain.spans.size(), 0);
+
+  vb6_grammar::parse_options options;
+  options.spans = true;
+  auto const located = vb6_grammar::parse_module(unit, options);
+  EXPECT_EQ(located.result.status, vb6_grammar::parse_status::ok);
+  EXPECT_GT(located.spans.size(), 0);
+
+  options.budget.max_steps = 5;
+  auto const stopped = vb6_grammar::parse_module(unit, options);
+  EXPECT_EQ(stopped.result.status, vb6_grammar::parse_status::budget_exhausted);
+}
+
+GTEST_TEST(vb6_parser_api, piece_text_same_as_contiguous)
+{
+  auto const unit = make_module(5) + "Sub bad()\r\n    Exit Foo\r\nEnd Sub\r\n";
+  vb6_ast::vb_module whole;
+  auto const expected = vb6_grammar::phrase_parse_module(unit, whole);
+
+  // pieces cutting through keywords, names and line ends
+  for(size_t piece_size : { 1, 7, 64 })
+  {
+    vb6_grammar::piece_text text;
+    for(size_t pos = 0; pos < unit.size(); pos += piece_size)
+      text.append(string_view(unit).substr(pos, piece_size));
+
+    vb6_ast::vb_module ast;
+    auto const res = vb6_grammar::phrase_parse_module(text, ast);
+    EXPECT_EQ(res.status, expected.status);
+    EXPECT_EQ(res.consumed, expected.consumed);
+    ASSERT_EQ(res.diagnostics.size(), expected.diagnostics.size());
+    EXPECT_EQ(res.diagnostics[0].where.line, expected.diagnostics[0].where.line);
+    EXPECT_EQ(res.diagnostics[0].where.column, expected.diagnostics[0].where.column);
+    EXPECT_EQ(ast.size(), whole.size());
+  }
+}
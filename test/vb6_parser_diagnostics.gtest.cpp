@@ -0,0 +1,109 @@
+//: vb6_parser_diagnostics.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_config.hpp"
+#include "vb6_parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string_view>
+
+using namespace std;
+namespace x3 = boost::spirit::x3;
+
+template <class ruleType, class attrType>
+bool parse_with_policy(string_view fragment, ruleType rule, attrType& attr,
+                       vb6_grammar::expectation_policy policy,
+                       vector<vb6_grammar::vb6_diagnostic>& diags)
+{
+  auto it1 = cbegin(fragment);
+  auto const it2 = cend(fragment);
+
+  stringstream out;
+  vb6_grammar::error_handler_type error_handler(it1, it2, out, "source.bas");
+  error_handler.policy(policy);
+
+  auto const parser = x3::with<vb6_grammar::vb6_error_handler_tag>(std::ref(error_handler))[rule];
+
+  bool res = x3::phrase_parse(it1, it2, parser, vb6_grammar::skip, attr);
+  diags = error_handler.diagnostics();
+  return res;
+}
+
+GTEST_TEST(vb6_parser_diagnostics, exit_statement_nothrow)
+{
+  vb6_ast::statements::exitStmt st;
+  vector<vb6_grammar::vb6_diagnostic> diags;
+  bool res = false;
+  EXPECT_NO_THROW(res = parse_with_policy("Exit Foo\r\n", vb6_grammar::statements::exitStmt, st,
+                                          vb6_grammar::expectation_policy::diagnose, diags));
+  EXPECT_FALSE(res);
+
+  ASSERT_EQ(diags.size(), 1);
+  EXPECT_EQ(diags[0].offset, 5);
+  EXPECT_EQ(diags[0].which, "Sub, Function, Property, Do, While or For");
+}
+
+GTEST_TEST(vb6_parser_diagnostics, exit_statement_throw)
+{
+  vb6_ast::statements::exitStmt st;
+  vector<vb6_grammar::vb6_diagnostic> diags;
+  EXPECT_THROW(parse_with_policy("Exit Foo\r\n", vb6_grammar::statements::exitStmt, st,
+                                 vb6_grammar::expectation_policy::throw_failure, diags),
+               x3::expectation_failure<vb6_grammar::iterator_type>);
+}
+
+GTEST_TEST(vb6_parser_diagnostics, goto_statement_nothrow)
+{
+  vb6_ast::statements::gotoStmt st;
+  vector<vb6_grammar::vb6_diagnostic> diags;
+  bool res = parse_with_policy("GoTo 10\r\n", vb6_grammar::statements::gotoStmt, st,
+                               vb6_grammar::expectation_policy::diagnose, diags);
+  EXPECT_FALSE(res);
+
+  ASSERT_EQ(diags.size(), 1);
+  EXPECT_EQ(diags[0].offset, 5);
+  EXPECT_EQ(diags[0].which, "label");
+}
+
+GTEST_TEST(vb6_parser_diagnostics, missing_end_sub_nothrow)
+{
+  vb6_ast::subDef st;
+  vector<vb6_grammar::vb6_diagnostic> diags;
+  auto str = "Sub foo()\r\n"
+             "    Exit Sub\r\n"
+             "End Function\r\n";
+  bool res = parse_with_policy(str, vb6_grammar::subDef, st,
+                               vb6_grammar::expectation_policy::diagnose, diags);
+  EXPECT_FALSE(res);
+
+  ASSERT_FALSE(diags.empty());
+  EXPECT_EQ(diags.back().offset, string_view(str).find("Function"));
+  EXPECT_EQ(diags.back().which, "Sub");
+}
+
+GTEST_TEST(vb6_parser_diagnostics, valid_input_has_no_diagnostics)
+{
+  vb6_ast::statements::redimStmt st;
+  vector<vb6_grammar::vb6_diagnostic> diags;
+  bool res = parse_with_policy("ReDim Preserve var1(15)\r\n", vb6_grammar::statements::redimStmt, st,
+                               vb6_grammar::expectation_policy::diagnose, diags);
+  EXPECT_TRUE(res);
+  EXPECT_TRUE(diags.empty());
+  EXPECT_TRUE(st.preserve);
+}
+
+GTEST_TEST(vb6_parser_diagnostics, rejected_branch_leaves_no_diagnostics)
+{
+  // redimStmt gives up at the missing '(', then the line parses as a call to ReDim
+  vb6_ast::statements::singleStmt st;
+  vector<vb6_grammar::vb6_diagnostic> diags;
+  bool res = parse_with_policy("ReDim x\r\n", vb6_grammar::statements::singleStmt, st,
+                               vb6_grammar::expectation_policy::diagnose, diags);
+  EXPECT_TRUE(res);
+  EXPECT_TRUE(diags.empty());
+}
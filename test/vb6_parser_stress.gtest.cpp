@@ -0,0 +1,182 @@
+//: vb6_parser_stress.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+// Built with -DVB6_PARSER_TSAN=ON, so that ThreadSanitizer watches every
+// parse made here.
+
+#include "vb6_ast_printer.hpp"
+#include "vb6_parser_api.hpp"
+#include "vb6_unit.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr unsigned nr_threads = 64;
+constexpr unsigned nr_rounds = 32;
+
+struct sample
+{
+  string name;
+  string source;
+  vb6_grammar::unit_layout layout;
+  string printed;     // the AST of a parse on its own
+  string diagnostics; // and what it reported
+  bool parsed = false; // to its end
+};
+
+// The units of data/ stop parsing in their first lines, those of
+// bench/corpus and this form are written with what the grammar supports.
+string const form_unit =
+  "VERSION 5.00\r\n"
+  "Begin VB.Form prova_form\r\n"
+  "   Caption         =   \"End\"\r\n"
+  "   Begin VB.CommandButton Command1\r\n"
+  "      Caption         =   \"Command1\"\r\n"
+  "   End\r\n"
+  "End\r\n"
+  "Attribute VB_Name = \"prova_form\"\r\n"
+  "Option Explicit\r\n"
+  "Sub Command1_Click()\r\n"
+  "    x = y\r\n"
+  "    Call bar(\"item\", 1, counter)\r\n"
+  "End Sub\r\n";
+
+string print(vb6_ast::vb_module const& ast)
+{
+  ostringstream os;
+  vb6_ast_printer{ os }(ast);
+  return os.str();
+}
+
+string describe(vb6_grammar::parse_result const& result)
+{
+  ostringstream os;
+  os << static_cast<int>(result.status) << ' ' << result.consumed << '\n';
+  for(auto& d : result.diagnostics)
+    os << d.where.line << ':' << d.where.column << ": " << d.which << '\n';
+  return os.str();
+}
+
+// laid out by sniff_unit and parsed by parse_unit, as vb6_parser does
+sample make_sample(string name, string source)
+{
+  sample s;
+  s.name = std::move(name);
+  s.source = std::move(source);
+  s.layout = vb6_grammar::sniff_unit(s.source, s.name);
+
+  vb6_grammar::parse_session session;
+  vb6_ast::vb_module ast;
+  auto const& result = session.parse_unit(s.source, s.layout, ast);
+  s.diagnostics = describe(result);
+  s.parsed = result.status == vb6_grammar::parse_status::ok;
+  s.printed = print(ast);
+  return s;
+}
+
+vector<sample> load_corpus()
+{
+  vector<sample> corpus;
+  for(auto dir : { VB6_DATA_DIR, VB6_BENCH_CORPUS_DIR })
+  {
+    for(auto& entry : fs::directory_iterator(dir))
+    {
+      auto const ext = entry.path().extension();
+      if(ext != ".bas" && ext != ".cls" && ext != ".frm")
+        continue;
+      ifstream in(entry.path(), ios::binary);
+      corpus.push_back(make_sample(entry.path().filename().string(),
+                                   { istreambuf_iterator<char>(in), istreambuf_iterator<char>() }));
+    }
+  }
+  corpus.push_back(make_sample("form_unit.frm", form_unit));
+  sort(corpus.begin(), corpus.end(), [](auto& a, auto& b) { return a.name < b.name; });
+  return corpus;
+}
+
+}
+
+GTEST_TEST(vb6_parser_stress, corpus_from_many_threads)
+{
+  auto const corpus = load_corpus();
+  // the units of bench/corpus and the form at least
+  ASSERT_GE(count_if(corpus.begin(), corpus.end(), [](auto& s) { return s.parsed; }), 4);
+
+  // every thread goes through the corpus starting from a different file,
+  // through all the entry points, and finds what a lone parse found
+  atomic<unsigned> mismatches = 0;
+  atomic<bool> go = false;
+  vector<thread> threads;
+  for(unsigned t = 0; t < nr_threads; ++t)
+  {
+    threads.emplace_back([&, t] {
+      while(!go.load(memory_order_acquire))
+        this_thread::yield();
+
+      vb6_grammar::parse_session session;
+      for(unsigned round = 0; round < nr_rounds; ++round)
+      {
+        for(size_t i = 0; i < corpus.size(); ++i)
+        {
+          auto& s = corpus[(i + t) % corpus.size()];
+          bool same = true;
+          if(s.layout.code_begin != 0)
+          {
+            // the designer is not vb6 code, only parse_unit skips it
+            vb6_ast::vb_module ast;
+            auto const& result = session.parse_unit(s.source, s.layout, ast);
+            same = print(ast) == s.printed && describe(result) == s.diagnostics;
+          }
+          else
+          {
+            switch((round + t) % 3)
+            {
+            case 0:
+            {
+              vb6_grammar::parse_options options;
+              options.spans = round % 2 != 0;
+              auto const parsed = vb6_grammar::parse_module(s.source, options);
+              same = print(parsed.ast) == s.printed && describe(parsed.result) == s.diagnostics;
+              break;
+            }
+            case 1:
+            {
+              auto const& result = session.parse_module(s.source);
+              same = print(session.module()) == s.printed && describe(result) == s.diagnostics;
+              break;
+            }
+            case 2:
+              same = describe(vb6_grammar::check_syntax(s.source)) == s.diagnostics;
+              break;
+            }
+          }
+          if(!same)
+            mismatches.fetch_add(1, memory_order_relaxed);
+        }
+      }
+    });
+  }
+
+  go.store(true, memory_order_release);
+  for(auto& t : threads)
+    t.join();
+
+  EXPECT_EQ(mismatches.load(), 0);
+}
@@ -0,0 +1,62 @@
+//: vb6_piece_table.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_piece_table.hpp"
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+GTEST_TEST(vb6_piece_table, iterates_across_pieces)
+{
+  vb6_grammar::piece_text const text({ "Sub ", "", "foo", "()\r\n", "E", "nd Sub" });
+  string const flat = "Sub foo()\r\nEnd Sub";
+
+  EXPECT_EQ(text.size(), flat.size());
+  EXPECT_EQ(text.piece_count(), 5);
+  EXPECT_EQ(text.str(), flat);
+  EXPECT_EQ(string(text.begin(), text.end()), flat);
+  EXPECT_EQ(text.end() - text.begin(), static_cast<ptrdiff_t>(flat.size()));
+
+  string backwards;
+  for(auto it = text.end(); it != text.begin();)
+    backwards += *--it;
+  EXPECT_EQ(backwards, string(flat.rbegin(), flat.rend()));
+}
+
+GTEST_TEST(vb6_piece_table, random_access)
+{
+  vb6_grammar::piece_text const text({ "abc", "de", "fghij" });
+  string_view const flat = "abcdefghij";
+
+  auto const first = text.begin();
+  for(size_t i = 0; i <= flat.size(); ++i)
+  {
+    auto const it = first + static_cast<ptrdiff_t>(i);
+    EXPECT_EQ(it.offset(), i);
+    EXPECT_EQ(it - first, static_cast<ptrdiff_t>(i));
+    if(i < flat.size())
+    {
+      EXPECT_EQ(*it, flat[i]);
+      EXPECT_EQ(first[static_cast<ptrdiff_t>(i)], flat[i]);
+    }
+    else
+      EXPECT_EQ(it, text.end());
+  }
+
+  auto it = text.end();
+  it -= 6;
+  EXPECT_EQ(*it, 'e');
+  it += 2;
+  EXPECT_EQ(*it, 'g');
+  EXPECT_LT(first, it);
+  EXPECT_EQ(next(first, 3), first + 3);
+}
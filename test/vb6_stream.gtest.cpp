@@ -0,0 +1,88 @@
+//: vb6_stream.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_parser_api.hpp"
+#include "vb6_stream.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+string repeated_module(int procedures)
+{
+  string unit = "Option Explicit\r\n";
+  for(int i = 0; i < procedures; ++i)
+  {
+    unit += "' procedure " + to_string(i) + "\r\n"
+            "Sub foo" + to_string(i) + "()\r\n"
+            "    x = y\r\n"
+            "    Call bar(\"item\", 1, counter)\r\n"
+            "End Sub\r\n";
+  }
+  return unit;
+}
+
+}
+
+GTEST_TEST(vb6_stream, chunked_source)
+{
+  istringstream in("0123456789");
+  vb6_grammar::chunked_source source{ in, 4 };
+
+  EXPECT_TRUE(source.fill());
+  EXPECT_EQ(source.window(), "0123");
+  source.consume(3);
+  EXPECT_EQ(source.window(), "3");
+  EXPECT_EQ(source.offset(), 3);
+  EXPECT_TRUE(source.fill());
+  EXPECT_TRUE(source.fill());
+  EXPECT_EQ(source.window(), "3456789");
+  EXPECT_TRUE(source.at_end());
+  EXPECT_FALSE(source.fill());
+  EXPECT_LE(source.peak_bytes(), 10);
+}
+
+GTEST_TEST(vb6_stream, same_items_as_whole_unit)
+{
+  auto const unit = repeated_module(200);
+
+  vb6_ast::vb_module whole;
+  ASSERT_EQ(vb6_grammar::phrase_parse_module(unit, whole).status, vb6_grammar::parse_status::ok);
+
+  istringstream in(unit);
+  vb6_ast::vb_module streamed;
+  auto const result = vb6_grammar::parse_module_stream(in, [&](vb6_ast::vb_module& items) {
+    streamed.insert(streamed.end(), make_move_iterator(items.begin()), make_move_iterator(items.end()));
+  }, 256);
+
+  EXPECT_EQ(result.status, vb6_grammar::parse_status::ok);
+  EXPECT_TRUE(result.diagnostics.empty());
+  EXPECT_EQ(result.consumed, unit.size());
+  EXPECT_EQ(result.items, whole.size());
+  EXPECT_EQ(streamed.size(), whole.size());
+  EXPECT_LT(result.peak_bytes, 1024);
+}
+
+GTEST_TEST(vb6_stream, diagnostics_in_stream_lines)
+{
+  auto const unit = repeated_module(50) + "Sub broken()\r\n    Exit Foo\r\nEnd Sub\r\n";
+
+  istringstream in(unit);
+  size_t items = 0;
+  auto const result = vb6_grammar::parse_module_stream(in, [&](vb6_ast::vb_module& batch) { items += batch.size(); }, 128);
+
+  EXPECT_EQ(result.status, vb6_grammar::parse_status::syntax_error);
+  ASSERT_EQ(result.diagnostics.size(), 1);
+  EXPECT_EQ(result.diagnostics[0].where.line, 253);
+  EXPECT_EQ(result.diagnostics[0].where.column, 10);
+  EXPECT_EQ(result.items, items);
+  EXPECT_LT(result.consumed, unit.size());
+}
@@ -0,0 +1,176 @@
+//: vb6_supervisor.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "test_scratch_dir.hpp"
+#include "vb6_supervisor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct corpus : scratch_dir
+{
+  vector<fs::path> files;
+
+  corpus()
+  {
+    for(auto name : { "a.bas", "crash.bas", "b.bas", "hang.bas", "c.bas" })
+    {
+      write(name, "Sub foo()\r\n    Exit Sub\r\nEnd Sub\r\n");
+      files.push_back(root / name);
+    }
+  }
+};
+
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+namespace {
+
+// run in the worker: the start of an answer on its socket to the
+// supervisor, the only one it has, and nothing more
+void stall_in_the_answer()
+{
+  for(int fd = 3; fd < 1024; ++fd)
+  {
+    struct stat st{};
+    if(::fstat(fd, &st) == 0 && S_ISSOCK(st.st_mode))
+    {
+      uint64_t const size = 1000;
+      ::send(fd, &size, sizeof(size), 0);
+      ::send(fd, "abc", 3, 0);
+    }
+  }
+  this_thread::sleep_for(chrono::seconds(30));
+}
+
+}
+
+GTEST_TEST(vb6_supervisor, crashes_and_hangs_are_quarantined)
+{
+  corpus c;
+
+  vb6_grammar::supervisor_options options;
+  options.processes = 2;
+  options.file_timeout = chrono::milliseconds(300);
+  options.quarantine_dir = c.root / "quarantine";
+  options.batch.format = vb6_grammar::output_format::vb;
+  options.before_file = [](fs::path const& file) {
+    if(file.filename() == "crash.bas")
+      std::raise(SIGSEGV);
+    if(file.filename() == "hang.bas")
+      this_thread::sleep_for(chrono::seconds(30));
+  };
+
+  vector<string> order;
+  auto const report = vb6_grammar::run_supervised(c.files, options, [&](vb6_grammar::file_result const& f) {
+    order.push_back(fs::path(f.name).filename().string());
+  });
+
+  EXPECT_EQ(order, (vector<string>{ "a.bas", "crash.bas", "b.bas", "hang.bas", "c.bas" }));
+  ASSERT_EQ(report.files.size(), 5);
+  EXPECT_EQ(report.failures(), 2);
+  EXPECT_EQ(report.quarantined(), 2);
+  EXPECT_EQ(report.restarts(), 2);
+  EXPECT_EQ(report.files[1].quarantined, "crashed the worker (signal " + to_string(SIGSEGV) + ')');
+  EXPECT_EQ(report.files[3].quarantined, "timed out after 300 ms");
+  EXPECT_FALSE(report.files[4].failed());
+  EXPECT_EQ(report.files[4].bytes, 34);
+
+  EXPECT_TRUE(fs::exists(c.root / "quarantine" / "1-crash.bas"));
+  EXPECT_TRUE(fs::exists(c.root / "quarantine" / "3-hang.bas"));
+
+  size_t files = 0;
+  for(auto& s : report.shards)
+    files += s.files;
+  EXPECT_EQ(files, 5);
+}
+
+GTEST_TEST(vb6_supervisor, quarantined_copies_kept_apart)
+{
+  corpus c;
+  c.write("other/crash.bas", "Sub bar()\r\nEnd Sub\r\n");
+  c.files.push_back(c.root / "other" / "crash.bas");
+
+  vb6_grammar::supervisor_options options;
+  options.quarantine_dir = c.root / "quarantine";
+  options.before_file = [](fs::path const& file) {
+    if(file.filename() == "crash.bas")
+      std::raise(SIGSEGV);
+  };
+  auto report = vb6_grammar::run_supervised(c.files, options);
+  EXPECT_EQ(report.quarantined(), 2);
+  EXPECT_EQ(fs::file_size(c.root / "quarantine" / "1-crash.bas"), 34);
+  EXPECT_EQ(fs::file_size(c.root / "quarantine" / "5-crash.bas"), 20);
+
+  // a quarantine that cannot be made gets reported
+  c.write("blocked", "");
+  options.quarantine_dir = c.root / "blocked";
+  report = vb6_grammar::run_supervised(c.files, options);
+  EXPECT_NE(report.files[1].errors.find(": could not be copied to "), string::npos) << report.files[1].errors;
+}
+
+GTEST_TEST(vb6_supervisor, stall_inside_an_answer_times_out)
+{
+  corpus c;
+
+  vb6_grammar::supervisor_options options;
+  options.processes = 1;
+  options.file_timeout = chrono::milliseconds(300);
+  options.before_file = [](fs::path const& file) {
+    if(file.filename() == "b.bas")
+      stall_in_the_answer();
+  };
+
+  auto const started = chrono::steady_clock::now();
+  auto const report = vb6_grammar::run_supervised(c.files, options);
+  EXPECT_LT(chrono::steady_clock::now() - started, chrono::seconds(10));
+
+  ASSERT_EQ(report.files.size(), 5);
+  EXPECT_EQ(report.quarantined(), 1);
+  EXPECT_EQ(report.files[2].quarantined, "timed out after 300 ms");
+  EXPECT_EQ(report.failures(), 1);
+  EXPECT_EQ(report.files[4].bytes, 34);
+}
+
+#endif
+
+GTEST_TEST(vb6_supervisor, same_results_as_threads)
+{
+  corpus c;
+
+  vb6_grammar::supervisor_options options;
+  options.processes = 3;
+  options.batch.format = vb6_grammar::output_format::json;
+  auto const report = vb6_grammar::run_supervised(c.files, options);
+
+  auto batch = options.batch;
+  auto const expected = vb6_grammar::run_batch(c.files, batch);
+
+  ASSERT_EQ(report.files.size(), expected.files.size());
+  for(size_t i = 0; i < report.files.size(); ++i)
+  {
+    EXPECT_EQ(report.files[i].name, expected.files[i].name);
+    EXPECT_EQ(report.files[i].output, expected.files[i].output);
+    EXPECT_EQ(report.files[i].bytes, expected.files[i].bytes);
+  }
+  EXPECT_EQ(report.restarts(), 0);
+}
@@ -0,0 +1,87 @@
+//: vb6_trace.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_parser_api.hpp"
+#include "vb6_trace.hpp"
+
+#include <boost/spirit/home/x3.hpp>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+string read_trace(filesystem::path const& fname)
+{
+  ifstream in(fname);
+  return { istreambuf_iterator<char>(in), istreambuf_iterator<char>() };
+}
+
+}
+
+GTEST_TEST(vb6_trace, module_events)
+{
+  string_view const unit = "Option Explicit\r\n"
+                           "Sub foo()\r\n"
+                           "    Exit Sub\r\n"
+                           "End Sub\r\n";
+  auto const fname = filesystem::temp_directory_path() / "vb6_trace.gtest.json";
+
+  vb6_grammar::start_trace(fname.string());
+  ASSERT_TRUE(vb6_grammar::trace_enabled());
+
+  vb6_ast::vb_module ast;
+  vb6_grammar::phrase_parse_module(unit, ast);
+  thread([] { vb6_grammar::trace_scope scope("worker", "test"); }).join();
+
+  ASSERT_TRUE(vb6_grammar::stop_trace());
+  EXPECT_FALSE(vb6_grammar::trace_enabled());
+
+  auto const trace = read_trace(fname);
+  filesystem::remove(fname);
+
+  EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0);
+  EXPECT_NE(trace.find("\"name\":\"phrase_parse\""), string::npos);
+  EXPECT_NE(trace.find("\"name\":\"procedure\""), string::npos);
+  EXPECT_NE(trace.find("\"detail\":\"bytes 17-51\""), string::npos);
+  EXPECT_NE(trace.find("\"name\":\"worker\",\"cat\":\"test\",\"ph\":\"X\",\"pid\":1,\"tid\":2"), string::npos);
+}
+
+GTEST_TEST(vb6_trace, failure_leaves_the_input)
+{
+  namespace x3 = boost::spirit::x3;
+  auto const fname = filesystem::temp_directory_path() / "vb6_trace.gtest.failure.json";
+
+  // the traced subject does not skip, the directive does when tracing, and
+  // the second alternative needs the blanks
+  auto const parser = vb6_grammar::traced("ab")[x3::no_skip[x3::lit("ab")]] | x3::no_skip[x3::lit("  ac")];
+  string_view const input = "  ac";
+
+  auto parse = [&] {
+    auto first = input.begin();
+    return x3::phrase_parse(first, input.end(), parser, x3::space) && first == input.end();
+  };
+  EXPECT_TRUE(parse());
+
+  vb6_grammar::start_trace(fname.string());
+  EXPECT_TRUE(parse());
+  vb6_grammar::stop_trace();
+  filesystem::remove(fname);
+}
+
+GTEST_TEST(vb6_trace, disabled)
+{
+  EXPECT_FALSE(vb6_grammar::trace_enabled());
+  vb6_grammar::trace_scope scope("nothing recorded");
+}
@@ -0,0 +1,115 @@
+//: vb6_unit.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_parser_api.hpp"
+#include "vb6_stream.hpp"
+#include "vb6_unit.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+string const form_header =
+  "VERSION 5.00\r\n"
+  "Object = \"{831FDD16-0C5C-11D2-A9FC-0000F8754DA1}#2.0#0\"; \"MSCOMCTL.OCX\"\r\n"
+  "Begin VB.Form prova_form\r\n"
+  "   Caption         =   \"End\"\r\n"
+  "   BeginProperty Font\r\n"
+  "      Name            =   \"Tahoma\"\r\n"
+  "   EndProperty\r\n"
+  "   Begin VB.CommandButton Command1\r\n"
+  "      Caption         =   \"Command1\"\r\n"
+  "   End\r\n"
+  "End\r\n";
+
+string const code =
+  "Attribute VB_Name = \"prova_form\"\r\n"
+  "Option Explicit\r\n"
+  "Sub foo()\r\n"
+  "    x = y\r\n"
+  "    Call bar(\"item\", 1, counter)\r\n"
+  "End Sub\r\n";
+
+}
+
+GTEST_TEST(vb6_unit, sniff_form)
+{
+  auto const layout = vb6_grammar::sniff_unit(form_header + code, "prova_form.frm");
+  EXPECT_EQ(layout.kind, vb6_grammar::unit_kind::form);
+  EXPECT_EQ(layout.code_begin, form_header.size());
+  EXPECT_EQ(layout.code_line, 11);
+  EXPECT_TRUE(layout.header_ended);
+
+  // the header wins over the extension
+  string control = form_header;
+  control.replace(control.find("VB.Form"), 7, "VB.UserControl");
+  EXPECT_EQ(vb6_grammar::sniff_unit(control + code, "misnamed.bas").kind, vb6_grammar::unit_kind::user_control);
+}
+
+GTEST_TEST(vb6_unit, sniff_class)
+{
+  string const header =
+    "VERSION 1.0 CLASS\r\n"
+    "BEGIN\r\n"
+    "  MultiUse = -1  'True\r\n"
+    "END\r\n";
+  auto const layout = vb6_grammar::sniff_unit(header + code);
+  EXPECT_EQ(layout.kind, vb6_grammar::unit_kind::class_module);
+  EXPECT_EQ(layout.code_begin, header.size());
+  EXPECT_EQ(layout.code_line, 4);
+}
+
+GTEST_TEST(vb6_unit, sniff_no_header)
+{
+  auto layout = vb6_grammar::sniff_unit(code, "dir.cls/prova.bas");
+  EXPECT_EQ(layout.kind, vb6_grammar::unit_kind::module);
+  EXPECT_EQ(layout.code_begin, 0);
+  EXPECT_TRUE(layout.header_ended);
+
+  layout = vb6_grammar::sniff_unit(code, "C:\\vb\\PROVA.CLS");
+  EXPECT_EQ(layout.kind, vb6_grammar::unit_kind::class_module);
+  EXPECT_EQ(layout.code_begin, 0);
+
+  // not closed, left to the parse
+  layout = vb6_grammar::sniff_unit(form_header.substr(0, form_header.find("End\r\nEnd")));
+  EXPECT_FALSE(layout.header_ended);
+  EXPECT_EQ(layout.code_begin, 0);
+}
+
+GTEST_TEST(vb6_unit, parse_form_code)
+{
+  auto const unit = form_header + code + "Sub bad()\r\n    Exit Foo\r\nEnd Sub\r\n";
+  auto const layout = vb6_grammar::sniff_unit(unit, "prova_form.frm");
+
+  vb6_grammar::parse_session session;
+  vb6_ast::vb_module ast;
+  auto const& result = session.parse_unit(unit, layout, ast);
+  EXPECT_EQ(result.status, vb6_grammar::parse_status::syntax_error);
+  ASSERT_EQ(result.diagnostics.size(), 1);
+  EXPECT_EQ(result.diagnostics[0].where.line, 19);
+  EXPECT_EQ(result.diagnostics[0].where.column, 10);
+  EXPECT_EQ(unit.substr(result.diagnostics[0].offset, 3), "Foo");
+
+  ast.clear();
+  EXPECT_EQ(session.parse_unit(form_header + code, layout, ast).status, vb6_grammar::parse_status::ok);
+  EXPECT_EQ(ast.size(), 3);
+}
+
+GTEST_TEST(vb6_unit, stream_skips_header)
+{
+  istringstream in(form_header + code);
+  size_t items = 0;
+  auto const result = vb6_grammar::parse_module_stream(in, [&](vb6_ast::vb_module& batch) { items += batch.size(); }, 16);
+  EXPECT_EQ(result.status, vb6_grammar::parse_status::ok);
+  EXPECT_EQ(result.kind, vb6_grammar::unit_kind::form);
+  EXPECT_EQ(result.consumed, form_header.size() + code.size());
+  EXPECT_EQ(items, 3);
+}
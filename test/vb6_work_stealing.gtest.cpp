@@ -0,0 +1,57 @@
+//: vb6_work_stealing.gtest.cpp
+
+// vb6_parser
+// Copyright (c) 2022 Federico Aponte
+// This code is licensed under GNU Software License (see LICENSE.txt for details)
+
+#include "vb6_work_stealing.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+GTEST_TEST(vb6_work_stealing, pop_newest_steal_oldest)
+{
+  vb6_grammar::work_stealing_deques<int> d(2);
+  for(int i = 1; i <= 3; ++i)
+    d.push(0, i);
+  EXPECT_EQ(d.size(), 3);
+
+  int task = 0;
+  EXPECT_FALSE(d.pop(1, task));
+  EXPECT_TRUE(d.steal(1, task));
+  EXPECT_EQ(task, 1);
+  EXPECT_TRUE(d.pop(0, task));
+  EXPECT_EQ(task, 3);
+  EXPECT_FALSE(d.steal(0, task)); // nothing on the other worker
+  EXPECT_TRUE(d.pop(0, task));
+  EXPECT_EQ(task, 2);
+  EXPECT_EQ(d.size(), 0);
+}
+
+GTEST_TEST(vb6_work_stealing, every_task_runs_once)
+{
+  constexpr int workers = 4, tasks = 10000;
+  vb6_grammar::work_stealing_deques<int> d(workers);
+  for(int i = 0; i < tasks; ++i)
+    d.push(0, i); // all on one worker, the others have to steal
+
+  vector<atomic<int>> runs(tasks);
+  vector<thread> threads;
+  for(int w = 0; w < workers; ++w)
+  {
+    threads.emplace_back([&, w] {
+      for(int task; d.pop(static_cast<size_t>(w), task) || d.steal(static_cast<size_t>(w), task);)
+        ++runs[static_cast<size_t>(task)];
+    });
+  }
+  for(auto& t : threads)
+    t.join();
+
+  for(auto& r : runs)
+    EXPECT_EQ(r, 1);
+}